@@ -0,0 +1,245 @@
+#pragma once
+
+#include "BinaryReader.h"
+#include "VirtualPointer.h"
+
+#if !defined(__cpp_impl_coroutine) || __cpp_impl_coroutine < 201902L
+#error "AsyncBinaryReader.h requires the coroutines of C++20 (/std:c++20 or -std=c++20)"
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+// Reads the bits of the data arriving by chunks, for example from a network connection, in a C++20 coroutine.
+// The reading methods return awaiters: co_await of a reading that runs past the received data suspends
+// the coroutine until addChunk() supplies enough bytes or finish() marks the end of the data,
+// so one parser coroutine per connection runs without blocking threads and without buffering whole PDUs.
+// The waiting coroutine is resumed inside addChunk() or finish(). Only one coroutine can wait at a time.
+// The reader is given only the received bytes, so the data never grows under it.
+// The chunks read through are dropped when the reader is given the next bytes, so the chunks of a long-lived
+// connection do not pile up.
+// The bytes are read in the order of the data, the order of the bits is chosen as in BinaryReader.
+template <class BitOrder = RuntimeOrder>
+class AsyncBinaryReader final {
+public:
+	using Reader = BinaryReader<uint8_t, ReversedBytes, BitOrder>;
+
+	class Awaiter;
+
+	explicit AsyncBinaryReader(reverse_bits_t reverseBits = !REVERSE_BITS);
+	AsyncBinaryReader(const AsyncBinaryReader& other) = delete;
+	AsyncBinaryReader& operator=(const AsyncBinaryReader& other) = delete;
+
+	// Appends the received bytes without copying and resumes the waiting coroutine if they are enough for it.
+	// The memory of a chunk must be valid till all its bits are read.
+	void addChunk(uint8_t* data, std::size_t sizeInBytes);
+	// marks the end of the data and resumes the waiting coroutine, its reading fails
+	void finish();
+
+	// co_await returns false and does not move the position if the data is finished before count bits.
+	Awaiter readBits(std::size_t count, std::size_t& value);
+	Awaiter lookBits(std::size_t count, std::size_t& value);
+	Awaiter skipBits(uint64_t count);
+	// waits for count received bits, then they can be read by getReader()
+	Awaiter ensureBits(uint64_t count);
+
+	// The reader of the received bits for the methods not repeated here (readUE(), VlcTable and so on),
+	// it can read the bits awaited by ensureBits(). The reader must not be given other data.
+	Reader& getReader();
+	// returns the count of the received bits that are not read yet
+	uint64_t getBufferedBitsCount() const;
+	// returns the count of the kept chunks, the chunks read through before the reader was given the data are dropped
+	std::size_t getBufferedChunksCount() const;
+	uint64_t getReadBitsCount() const;
+	bool isFinished() const;
+
+	class Awaiter final {
+	public:
+		bool await_ready();
+		void await_suspend(std::coroutine_handle<> coroutine);
+		bool await_resume();
+
+	private:
+		enum class Operation {
+			READ,
+			LOOK,
+			SKIP,
+			ENSURE
+		};
+
+		AsyncBinaryReader& m_owner;
+		Operation m_operation;
+		uint64_t m_count;
+		std::size_t* m_value;
+
+		Awaiter(AsyncBinaryReader& owner, Operation operation, uint64_t count, std::size_t* value);
+
+		friend class AsyncBinaryReader;
+	};
+
+private:
+	Reader m_reader;
+	// the chunks of the data from the byte where the data of the reader begins
+	VirtualPointer<uint8_t> m_data{};
+	std::size_t m_chunksCount = 0;
+	uint64_t m_readerDataOffset = 0;
+	std::size_t m_readerDataSize = 0;
+	uint64_t m_receivedSize = 0;
+	bool m_finished = false;
+	std::coroutine_handle<> m_waiting{};
+	uint64_t m_waitingBits = 0;
+
+	// gives the reader all the received bytes from its current position if it has less than count bits
+	// and drops the chunks before the position
+	void updateReaderData(uint64_t count);
+	void resumeWaiting();
+};
+
+template <class BitOrder>
+AsyncBinaryReader<BitOrder>::AsyncBinaryReader(const reverse_bits_t reverseBits) :
+	m_reader(REVERSE_BYTES, reverseBits)
+{
+}
+
+template <class BitOrder>
+void AsyncBinaryReader<BitOrder>::addChunk(uint8_t* data, const std::size_t sizeInBytes) {
+	assert(!m_finished);
+	if (!sizeInBytes) {
+		return;
+	}
+	m_data.addChunk(data, sizeInBytes);
+	++m_chunksCount;
+	m_receivedSize += sizeInBytes;
+	if (m_waiting && getBufferedBitsCount() >= m_waitingBits) {
+		resumeWaiting();
+	}
+}
+
+template <class BitOrder>
+void AsyncBinaryReader<BitOrder>::finish() {
+	m_finished = true;
+	if (m_waiting) {
+		resumeWaiting();
+	}
+}
+
+template <class BitOrder>
+inline typename AsyncBinaryReader<BitOrder>::Awaiter AsyncBinaryReader<BitOrder>::readBits(const std::size_t count, std::size_t& value) {
+	return Awaiter(*this, Awaiter::Operation::READ, count, &value);
+}
+
+template <class BitOrder>
+inline typename AsyncBinaryReader<BitOrder>::Awaiter AsyncBinaryReader<BitOrder>::lookBits(const std::size_t count, std::size_t& value) {
+	return Awaiter(*this, Awaiter::Operation::LOOK, count, &value);
+}
+
+template <class BitOrder>
+inline typename AsyncBinaryReader<BitOrder>::Awaiter AsyncBinaryReader<BitOrder>::skipBits(const uint64_t count) {
+	return Awaiter(*this, Awaiter::Operation::SKIP, count, nullptr);
+}
+
+template <class BitOrder>
+inline typename AsyncBinaryReader<BitOrder>::Awaiter AsyncBinaryReader<BitOrder>::ensureBits(const uint64_t count) {
+	return Awaiter(*this, Awaiter::Operation::ENSURE, count, nullptr);
+}
+
+template <class BitOrder>
+inline typename AsyncBinaryReader<BitOrder>::Reader& AsyncBinaryReader<BitOrder>::getReader() {
+	return m_reader;
+}
+
+template <class BitOrder>
+inline uint64_t AsyncBinaryReader<BitOrder>::getBufferedBitsCount() const {
+	return multiplyBy8(m_receivedSize - m_readerDataOffset) - m_reader.getReadBitsCount();
+}
+
+template <class BitOrder>
+inline std::size_t AsyncBinaryReader<BitOrder>::getBufferedChunksCount() const {
+	return m_chunksCount;
+}
+
+template <class BitOrder>
+inline uint64_t AsyncBinaryReader<BitOrder>::getReadBitsCount() const {
+	return multiplyBy8(m_readerDataOffset) + m_reader.getReadBitsCount();
+}
+
+template <class BitOrder>
+inline bool AsyncBinaryReader<BitOrder>::isFinished() const {
+	return m_finished;
+}
+
+template <class BitOrder>
+void AsyncBinaryReader<BitOrder>::updateReaderData(const uint64_t count) {
+	const std::size_t readBits = m_reader.getReadBitsCount();
+	if (multiplyBy8(static_cast<uint64_t>(m_readerDataSize)) - readBits >= count || m_readerDataOffset + m_readerDataSize == m_receivedSize) {
+		return;
+	}
+	// the chunks before the first unread byte are walked once and dropped
+	const std::size_t firstUnreadByte = static_cast<std::size_t>(divideBy8(readBits));
+	m_readerDataOffset += firstUnreadByte;
+	m_readerDataSize = static_cast<std::size_t>(m_receivedSize - m_readerDataOffset);
+	VirtualPointer<uint8_t> from = m_data + firstUnreadByte;
+	VirtualPointer<uint8_t> unread{};
+	m_chunksCount = 0;
+	for (std::size_t remain = m_readerDataSize; remain; ++m_chunksCount) {
+		std::size_t count;
+		uint8_t* chunk = from.contiguousData(count);
+		count = std::min(count, remain);
+		unread.addChunk(chunk, count);
+		from += count;
+		remain -= count;
+	}
+	m_data = unread;
+	m_reader.setData(m_data, m_readerDataSize);
+	m_reader.skipBits(readBits & LITTLE_BITS[3]);
+}
+
+template <class BitOrder>
+void AsyncBinaryReader<BitOrder>::resumeWaiting() {
+	const std::coroutine_handle<> waiting = m_waiting;
+	m_waiting = nullptr;
+	waiting.resume();
+}
+
+template <class BitOrder>
+AsyncBinaryReader<BitOrder>::Awaiter::Awaiter(AsyncBinaryReader& owner, const Operation operation, const uint64_t count, std::size_t* value) :
+	m_owner(owner),
+	m_operation(operation),
+	m_count(count),
+	m_value(value)
+{
+}
+
+template <class BitOrder>
+inline bool AsyncBinaryReader<BitOrder>::Awaiter::await_ready() {
+	return m_owner.getBufferedBitsCount() >= m_count || m_owner.m_finished;
+}
+
+template <class BitOrder>
+inline void AsyncBinaryReader<BitOrder>::Awaiter::await_suspend(const std::coroutine_handle<> coroutine) {
+	assert(!m_owner.m_waiting);
+	m_owner.m_waiting = coroutine;
+	m_owner.m_waitingBits = m_count;
+}
+
+template <class BitOrder>
+bool AsyncBinaryReader<BitOrder>::Awaiter::await_resume() {
+	if (m_owner.getBufferedBitsCount() < m_count) {
+		return false;
+	}
+	m_owner.updateReaderData(m_count);
+	Reader& reader = m_owner.m_reader;
+	switch (m_operation) {
+	case Operation::READ:
+		return reader.readBits(static_cast<std::size_t>(m_count), *m_value);
+	case Operation::LOOK:
+		return reader.lookBits(static_cast<std::size_t>(m_count), *m_value);
+	case Operation::SKIP:
+		return reader.skipBits(static_cast<std::size_t>(m_count));
+	default:
+		return true;
+	}
+}
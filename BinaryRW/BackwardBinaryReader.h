@@ -0,0 +1,325 @@
+#pragma once
+
+#include "BitMask.h"
+#include "Reverser.h"
+#include "Statistics.h"
+#include "VirtualPointer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+#include <type_traits>
+
+
+// Reads the data from its end toward its beginning, as zstd and FSE streams are read:
+// the data is one little-endian number, the first read bits are the highest bits of the last byte.
+// The bits of every byte are read from the highest one, or from the lowest one if the bits are reversed.
+// The cache is refilled by whole words loaded from the memory preceding the loaded data.
+template <class T, class BitOrder = RuntimeOrder>
+class BackwardBinaryReader final {
+public:
+	BackwardBinaryReader();
+	explicit BackwardBinaryReader(reverse_bits_t reverseBits);
+
+	BackwardBinaryReader(const BackwardBinaryReader& other) = default;
+	BackwardBinaryReader(BackwardBinaryReader&& other) = default;
+
+	~BackwardBinaryReader() noexcept = default;
+
+	BackwardBinaryReader& operator=(const BackwardBinaryReader& other) = default;
+	BackwardBinaryReader& operator=(BackwardBinaryReader&& other) = default;
+
+	void setReverseBits(reverse_bits_t val);
+
+	// the reading begins at the end of the data [address, address + sizeInBytes)
+	void setData(const T* address, std::size_t sizeInBytes);
+	// every element of the virtual data gives one byte of the data, its lowest one, as in BinaryReader
+	void setData(const VirtualPointer<T>& address, std::size_t sizeInBytes);
+
+	bool readBits(std::size_t count, std::size_t& value);
+	template <class V>
+	bool readBits(std::size_t count, V& value);
+	bool lookBits(std::size_t count, std::size_t& value) const;
+	bool skipBits(std::size_t count);
+
+	// The count of bits guaranteed to be in the cache after refill() unless the data is over.
+	static constexpr std::size_t REFILLED_BITS = multiplyBy8(sizeof(std::size_t)) - 7;
+	// tops up the cache by the whole bytes preceding the loaded data
+	void refill();
+	// returns the count of the bits left in the cache
+	std::size_t getCachedBitsCount() const;
+	// Work only with the cached bits, without checks of the count and the bounds.
+	// The caller must not take more than getCachedBitsCount() bits in total till the next refill().
+	std::size_t lookBitsUnchecked(std::size_t count) const;
+	std::size_t readBitsUnchecked(std::size_t count);
+	void skipBitsUnchecked(std::size_t count);
+
+	// returns the count of the bits that are not read yet
+	uint64_t getRemainBitsCount() const;
+	std::size_t getReadBitsCount() const;
+	void resetReadBitsCount();
+
+private:
+	reverse_bits_t m_reverseBits;
+	// the first loaded byte, the bytes before it are not loaded yet
+	const uint8_t* m_typedData = nullptr;
+	VirtualPointer<T> m_vData{};
+	std::size_t m_notLoadedBytes = 0;
+	// the cached bits are the highest bits of the cache, the next bit to read is the highest one
+	std::size_t m_cache = 0;
+	std::size_t m_cachedBits = 0;
+	std::size_t m_readBitsCount = 0;
+
+	static constexpr std::size_t BITNESS = multiplyBy8(sizeof(std::size_t));
+
+	// returns count bytes beginning at from in the highest bytes of the word, the last byte is the highest one
+	std::size_t getBytes(const uint8_t* from, std::size_t count) const;
+	// reads the bytes directly when they lie inside one chunk, otherwise stitches the bytes of the chunks
+	std::size_t getBytes(const VirtualPointer<T>& from, std::size_t count) const;
+	// takes count bits from the highest bits of the cache, count must not exceed the cached bits
+	std::size_t takeBits(std::size_t count);
+};
+
+template <class T, class BitOrder>
+constexpr std::size_t BackwardBinaryReader<T, BitOrder>::REFILLED_BITS;
+
+template <class T, class BitOrder>
+BackwardBinaryReader<T, BitOrder>::BackwardBinaryReader() :
+	m_reverseBits(!REVERSE_BITS)
+{
+}
+
+template <class T, class BitOrder>
+BackwardBinaryReader<T, BitOrder>::BackwardBinaryReader(const reverse_bits_t reverseBits) :
+	m_reverseBits(reverseBits)
+{
+}
+
+template <class T, class BitOrder>
+void BackwardBinaryReader<T, BitOrder>::setReverseBits(const reverse_bits_t val) {
+	m_reverseBits = val;
+}
+
+template <class T, class BitOrder>
+void BackwardBinaryReader<T, BitOrder>::setData(const T* address, const std::size_t sizeInBytes) {
+	assert(nullptr != address);
+	m_typedData = reinterpret_cast<const uint8_t*>(address) + sizeInBytes;
+	m_notLoadedBytes = sizeInBytes;
+	m_cache = 0;
+	m_cachedBits = 0;
+	refill();
+	resetReadBitsCount();
+}
+
+template <class T, class BitOrder>
+void BackwardBinaryReader<T, BitOrder>::setData(const VirtualPointer<T>& address, const std::size_t sizeInBytes) {
+	m_typedData = nullptr;
+	m_vData = address;
+	m_vData += sizeInBytes;
+	m_notLoadedBytes = sizeInBytes;
+	m_cache = 0;
+	m_cachedBits = 0;
+	refill();
+	resetReadBitsCount();
+}
+
+template <class T, class BitOrder>
+bool BackwardBinaryReader<T, BitOrder>::readBits(const std::size_t count, std::size_t& value) {
+	if (count > BITNESS || static_cast<uint64_t>(count) > getRemainBitsCount()) {
+		return false;
+	}
+	if (count > m_cachedBits) {
+		refill();
+		if (count > m_cachedBits) {
+			// the bits are taken by two parts around one more refill
+			const std::size_t highBitsCount = m_cachedBits;
+			const std::size_t highBits = takeBits(highBitsCount);
+			refill();
+			value = (highBits << (count - highBitsCount)) | takeBits(count - highBitsCount);
+			m_readBitsCount += count;
+			return true;
+		}
+	}
+	value = takeBits(count);
+	m_readBitsCount += count;
+	return true;
+}
+
+template <class T, class BitOrder>
+template <class V>
+bool BackwardBinaryReader<T, BitOrder>::readBits(const std::size_t count, V& value) {
+	static_assert(std::is_integral<V>::value, "ReadBits allows only integral types");
+	std::size_t bits;
+	if (!readBits(count, bits)) {
+		return false;
+	}
+	value = static_cast<V>(bits);
+	return true;
+}
+
+template <class T, class BitOrder>
+bool BackwardBinaryReader<T, BitOrder>::lookBits(const std::size_t count, std::size_t& value) const {
+	if (count > BITNESS || static_cast<uint64_t>(count) > getRemainBitsCount()) {
+		return false;
+	}
+	if (count <= m_cachedBits) {
+		value = lookBitsUnchecked(count);
+		return true;
+	}
+	countStatistic(&HotPathStatistics::slowPaths);
+	const std::size_t lowBitsCount = count - m_cachedBits;
+	const std::size_t bytesCount = static_cast<std::size_t>(divideBy8(lowBitsCount + BITS_IN_BYTE - 1));
+	std::size_t lowBits;
+	if (m_typedData) {
+		lowBits = getBytes(m_typedData - bytesCount, bytesCount);
+	}
+	else {
+		VirtualPointer<T> from = m_vData;
+		from -= bytesCount;
+		lowBits = getBytes(from, bytesCount);
+	}
+	value = lowBits >> (BITNESS - lowBitsCount);
+	if (m_cachedBits) {
+		value |= (m_cache >> (BITNESS - m_cachedBits)) << lowBitsCount;
+	}
+	return true;
+}
+
+template <class T, class BitOrder>
+bool BackwardBinaryReader<T, BitOrder>::skipBits(std::size_t count) {
+	if (static_cast<uint64_t>(count) > getRemainBitsCount()) {
+		return false;
+	}
+	m_readBitsCount += count;
+	if (count <= m_cachedBits) {
+		takeBits(count);
+		return true;
+	}
+	countStatistic(&HotPathStatistics::seeks);
+	count -= m_cachedBits;
+	m_cache = 0;
+	m_cachedBits = 0;
+	const std::size_t bytesCount = static_cast<std::size_t>(divideBy8(count));
+	if (m_typedData) {
+		m_typedData -= bytesCount;
+	}
+	else {
+		m_vData -= bytesCount;
+	}
+	m_notLoadedBytes -= bytesCount;
+	refill();
+	takeBits(count & LITTLE_BITS[3]);
+	return true;
+}
+
+template <class T, class BitOrder>
+void BackwardBinaryReader<T, BitOrder>::refill() {
+	std::size_t count = std::min(static_cast<std::size_t>(divideBy8(BITNESS - m_cachedBits)), m_notLoadedBytes);
+	if (!count) {
+		return;
+	}
+	countStatistic(&HotPathStatistics::cacheRefills);
+	std::size_t word;
+	if (m_typedData) {
+		m_typedData -= count;
+		word = getBytes(m_typedData, count);
+	}
+	else {
+		m_vData -= count;
+		word = getBytes(m_vData, count);
+	}
+	m_cache |= word >> m_cachedBits;
+	m_cachedBits += multiplyBy8(count);
+	m_notLoadedBytes -= count;
+}
+
+template <class T, class BitOrder>
+inline std::size_t BackwardBinaryReader<T, BitOrder>::getCachedBitsCount() const {
+	return m_cachedBits;
+}
+
+template <class T, class BitOrder>
+inline std::size_t BackwardBinaryReader<T, BitOrder>::lookBitsUnchecked(const std::size_t count) const {
+	assert(count <= m_cachedBits && count < BITNESS);
+	return count ? m_cache >> (BITNESS - count) : 0;
+}
+
+template <class T, class BitOrder>
+inline std::size_t BackwardBinaryReader<T, BitOrder>::readBitsUnchecked(const std::size_t count) {
+	assert(count < BITNESS);
+	m_readBitsCount += count;
+	return takeBits(count);
+}
+
+template <class T, class BitOrder>
+inline void BackwardBinaryReader<T, BitOrder>::skipBitsUnchecked(const std::size_t count) {
+	assert(count < BITNESS);
+	m_readBitsCount += count;
+	takeBits(count);
+}
+
+template <class T, class BitOrder>
+inline uint64_t BackwardBinaryReader<T, BitOrder>::getRemainBitsCount() const {
+	return m_cachedBits + multiplyBy8(static_cast<uint64_t>(m_notLoadedBytes));
+}
+
+template <class T, class BitOrder>
+inline std::size_t BackwardBinaryReader<T, BitOrder>::getReadBitsCount() const {
+	return m_readBitsCount;
+}
+
+template <class T, class BitOrder>
+inline void BackwardBinaryReader<T, BitOrder>::resetReadBitsCount() {
+	m_readBitsCount = 0;
+}
+
+template <class T, class BitOrder>
+inline std::size_t BackwardBinaryReader<T, BitOrder>::getBytes(const uint8_t* from, const std::size_t count) const {
+	// the memory of the supported hosts is little-endian, so the last byte is loaded to the highest byte
+	std::size_t word = 0;
+	if (sizeof(std::size_t) == count) {
+		std::memcpy(&word, from, sizeof(std::size_t));
+	}
+	else {
+		std::memcpy(&word, from, count);
+		word <<= multiplyBy8(sizeof(std::size_t) - count);
+	}
+	if (BitOrder::get(m_reverseBits)) {
+		word = reverseBits(word);
+	}
+	return word;
+}
+
+template <class T, class BitOrder>
+std::size_t BackwardBinaryReader<T, BitOrder>::getBytes(const VirtualPointer<T>& from, const std::size_t count) const {
+	std::size_t available;
+	const T* data = from.contiguousData(available);
+	if (sizeof(T) == 1 && nullptr != data && available >= count) {
+		return getBytes(reinterpret_cast<const uint8_t*>(data), count);
+	}
+	countStatistic(&HotPathStatistics::slowPaths);
+	uint8_t bytes[sizeof(std::size_t)];
+	if (sizeof(T) == 1) {
+		memcpy(bytes, from, count);
+	}
+	else {
+		for (std::size_t i = 0; i < count; ++i) {
+			bytes[i] = static_cast<uint8_t>(from[i] & LITTLE_BITS[BITS_IN_BYTE]);
+		}
+	}
+	return getBytes(bytes, count);
+}
+
+template <class T, class BitOrder>
+inline std::size_t BackwardBinaryReader<T, BitOrder>::takeBits(const std::size_t count) {
+	assert(count <= m_cachedBits);
+	if (!count) {
+		return 0;
+	}
+	const std::size_t value = m_cache >> (BITNESS - count);
+	m_cache = count < BITNESS ? m_cache << count : 0;
+	m_cachedBits -= count;
+	return value;
+}
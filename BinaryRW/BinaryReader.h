@@ -1,17 +1,20 @@
 ﻿#pragma once
 
 #include "BitMask.h"
+#include "BitUnpacking.h"
 #include "Reverser.h"
+#include "Statistics.h"
 #include "VirtualPointer.h"
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <cassert>
 #include <algorithm>
 #include <type_traits>
 
 
-template <class T>
+template <class T, class ByteOrder = RuntimeOrder, class BitOrder = RuntimeOrder>
 class BinaryReader {
 public:
 	BinaryReader();
@@ -30,6 +33,7 @@ public:
 	void setReverseBytes(reverse_bytes_t val);
 
 	void setData(const T* address, std::size_t sizeInBytes);
+	// every element of the virtual data gives one byte of the data, its lowest one, so the size counts the elements
 	void setData(const VirtualPointer<T>& address, std::size_t sizeInBytes);
 
 	bool readBits(std::size_t count, std::size_t& value);
@@ -38,6 +42,67 @@ public:
 	bool lookBits(std::size_t count, std::size_t& value) const;
 	bool skipBits(std::size_t count);
 
+	// The reading with the sticky error: every failed reading (including the methods above) sets the error flag
+	// that stays set till clearError() or setData(), so a structure is parsed by straight-line code
+	// and the flag is checked once after it. These methods return zero if the data is over and do not move the position.
+	// lookBits() does not set the flag, because it does not read.
+	std::size_t readBits(std::size_t count);
+	std::size_t lookBits(std::size_t count) const;
+	bool hasError() const;
+	void clearError();
+
+	// Exp-Golomb codes ue(v) and se(v) with up to (BITNESS / 2 - 1) leading zero bits.
+	// Return false, set the error flag and do not move the position if the code is longer or the data is over.
+	template <class V>
+	bool readUE(V& value);
+	template <class V>
+	bool readSE(V& value);
+
+	// The count of bits guaranteed to be in the cache after refill() unless the data is over.
+	static constexpr std::size_t REFILLED_BITS = multiplyBy8(sizeof(std::size_t)) - 7;
+	// Tops up the cache starting from the byte of the current bit, so that the cache keeps
+	// at least REFILLED_BITS bits or all the remaining bits when there are less of them.
+	void refill();
+	// returns the count of the bits left in the cache
+	std::size_t getCachedBitsCount() const;
+	// Work only with the cached bits, without checks of the count and the bounds.
+	// The caller must not take more than getCachedBitsCount() bits in total till the next refill(), zero bits can be taken.
+	std::size_t lookBitsUnchecked(std::size_t count) const;
+	std::size_t readBitsUnchecked(std::size_t count);
+	void skipBitsUnchecked(std::size_t count);
+
+	// Reads count values of width bits (1 to MAX_PACKED_WIDTH) packed one after another.
+	// MSB_FIRST reads the same values as readBits(width, value) in a loop. LSB_FIRST reads the values packed
+	// from the lowest bits of the bytes (as readBits(8) returns the bytes), the current bit must be the first bit of a byte
+	// and the whole bytes of the values are skipped. When the bytes are read in the order of the memory with
+	// the direct order of the bits, the values are unpacked by the kernels of BitUnpacking.h right from the data,
+	// only the values crossing the chunks of a virtual pointer are read separately.
+	// Returns false, sets the error flag and does not move the position if the width is wrong or the data is over.
+	bool readPackedArray(std::size_t width, std::size_t count, uint32_t* values, BitPacking packing = BitPacking::MSB_FIRST);
+
+	// Puts to view the next sizeInBytes bytes of the data without copying and skips them.
+	// The view is the memory of the data, so the bytes must be read in the order of the memory (REVERSE_BYTES):
+	// the call does not compile for DirectBytes and fails for the runtime order without REVERSE_BYTES.
+	// Returns false if the current bit is not the first bit of a byte or the data is over.
+	bool readView(std::size_t sizeInBytes, VirtualPointer<T>& view);
+
+	// The state of the reading. Taking and restoring it does not copy the virtual pointer
+	// and does not walk its chunks. A checkpoint can be restored only while the data set by setData is the same.
+	struct Checkpoint final
+	{
+		const uint8_t* typedData;
+		typename VirtualPointer<T>::Position vDataPosition;
+		std::size_t lastCacheSize;
+		std::size_t groupOffset;
+		uint64_t remainDataSize;
+		std::size_t cache;
+		uint16_t bitPos;
+		std::size_t readBitsCount;
+		bool error;
+	};
+	Checkpoint mark() const;
+	void rewind(const Checkpoint& checkpoint);
+
 	T* getCurrentDataPtr();
 	VirtualPointer<T> getCurrentVirtualDataPtr();
 
@@ -52,29 +117,50 @@ private:
 	VirtualPointer<T> m_vData{};
 	// to return to the current data pointer excluding the cache
 	std::size_t m_lastCacheSize = 0;
+	// The bytes are loaded to the cache by groups of sizeof(std::size_t) bytes (the first and the last ones can be shorter),
+	// the orders other than the order of the memory reverse the bytes of a group. refill() can take the first bytes
+	// of the group at the data pointer, their count is kept here. It is always zero in the order of the memory.
+	std::size_t m_groupOffset = 0;
 	// remain data bytesRemaining in bits
 	uint64_t m_remainDataSize = 0;
 	std::size_t m_cache = 0;
 	uint16_t m_bitPos = 0;
 	std::size_t m_readBitsCount = 0;
+	bool m_error = false;
 	
 	static constexpr std::size_t BITNESS = multiplyBy8(sizeof(std::size_t));
 
+	// puts a word loaded from the memory of a little-endian host into the order of the cache
+	std::size_t orderWord(std::size_t word) const;
 	std::size_t getBytes(const uint8_t* from, std::size_t count) const;
-	std::size_t getBytes(VirtualPointer<T> from, std::size_t count) const;
+	// reads the word directly when it lies inside one chunk, otherwise stitches the bytes of the chunks
+	std::size_t getBytes(const VirtualPointer<T>& from, std::size_t count) const;
 	void updateCache();
+	// returns the next count bytes after the cache, bytesAfterCache is the count of the data bytes after the cache
+	template <class Pointer>
+	std::size_t getNextBytes(const Pointer& from, std::size_t count, uint64_t bytesAfterCache) const;
+	// moves the data pointer and the group offset over the next count bytes after the cache
+	template <class Pointer>
+	void moveNextBytes(Pointer& from, std::size_t count, uint64_t bytesAfterCache);
 	// similar to updateCache() but can skip some caches, 
 	// works a little slower and undefined in case of first set of cache
 	void updateFarCache();
 	void updateFarCache(std::size_t skipBitsAlignedSizeT);
 	std::size_t lookNextCache() const;
+	// returns the count of the bytes of the cache from the byte of the current bit to the end of the cache
+	std::size_t getUnreadCacheBytes() const;
+	// unpacks the values lying in the contiguous memory of the current bit and returns their count
+	std::size_t unpackContiguousValues(std::size_t width, std::size_t count, uint32_t* values, BitPacking packing);
+	// reads up to eight LSB_FIRST values by bytes and returns their count
+	std::size_t readLsbFirstGroup(std::size_t width, std::size_t count, uint32_t* values);
 };
 
-template <class T>
+template <class T, class ByteOrder, class BitOrder>
 template <class V>
-bool BinaryReader<T>::readBits(const std::size_t count, V& value) {
+bool BinaryReader<T, ByteOrder, BitOrder>::readBits(const std::size_t count, V& value) {
 	static_assert(std::is_integral<V>::value, "ReadBits allows only integral types");
 	if (static_cast<uint64_t>(count) > m_remainDataSize || count > BITNESS) {
+		m_error = true;
 		return false;
 	}
 	if (count + m_bitPos > BITNESS) {
@@ -86,8 +172,8 @@ bool BinaryReader<T>::readBits(const std::size_t count, V& value) {
 			value = 0;
 		}
 		updateCache();
-		m_bitPos = bitsFromNextCache;
-		value |= static_cast<V>(m_cache >> (BITNESS - bitsFromNextCache));
+		m_bitPos += bitsFromNextCache;
+		value |= static_cast<V>(m_cache >> (BITNESS - m_bitPos));
 	}
 	else {
 		value = static_cast<V>((m_cache >> (BITNESS - m_bitPos - count)) & LITTLE_BITS[count]);
@@ -98,33 +184,35 @@ bool BinaryReader<T>::readBits(const std::size_t count, V& value) {
 	return true;
 }
 
-template<typename T>
-void BinaryReader<T>::setData(const VirtualPointer<T>& address, std::size_t sizeInBytes) {
+template <class T, class ByteOrder, class BitOrder>
+void BinaryReader<T, ByteOrder, BitOrder>::setData(const VirtualPointer<T>& address, std::size_t sizeInBytes) {
 	m_remainDataSize = multiplyBy8(static_cast<uint64_t>(sizeInBytes));
 	m_cache = 0;
 	m_typedData = nullptr;
 	m_vData = address;
 	m_bitPos = 0;
+	m_groupOffset = 0;
+	m_error = false;
 	updateCache();
 	resetReadBitsCount();
 }
 
-template <class T>
-BinaryReader<T>::BinaryReader() :
+template <class T, class ByteOrder, class BitOrder>
+BinaryReader<T, ByteOrder, BitOrder>::BinaryReader() :
 	m_reverseBytes(REVERSE_BYTES),
 	m_reverseBits(!REVERSE_BITS)
 {
 }
 
-template <class T>
-BinaryReader<T>::BinaryReader(const reverse_bytes_t reverseBytes) :
+template <class T, class ByteOrder, class BitOrder>
+BinaryReader<T, ByteOrder, BitOrder>::BinaryReader(const reverse_bytes_t reverseBytes) :
 	m_reverseBytes(reverseBytes),
 	m_reverseBits(!REVERSE_BITS)
 {
 }
 
-template <class T>
-BinaryReader<T>::BinaryReader(reverse_bytes_t reverseBytes, reverse_bits_t reverseBits) {
+template <class T, class ByteOrder, class BitOrder>
+BinaryReader<T, ByteOrder, BitOrder>::BinaryReader(reverse_bytes_t reverseBytes, reverse_bits_t reverseBits) {
 	m_typedData = nullptr;
 	m_reverseBytes = reverseBytes;
 	m_reverseBits = reverseBits;
@@ -132,30 +220,33 @@ BinaryReader<T>::BinaryReader(reverse_bytes_t reverseBytes, reverse_bits_t rever
 	resetReadBitsCount();
 }
 
-template <class T>
-void BinaryReader<T>::setReverseBits(reverse_bits_t val) {
+template <class T, class ByteOrder, class BitOrder>
+void BinaryReader<T, ByteOrder, BitOrder>::setReverseBits(reverse_bits_t val) {
 	m_reverseBits = val;
 }
 
-template <class T>
-void BinaryReader<T>::setReverseBytes(reverse_bytes_t val) {
+template <class T, class ByteOrder, class BitOrder>
+void BinaryReader<T, ByteOrder, BitOrder>::setReverseBytes(reverse_bytes_t val) {
 	m_reverseBytes = val;
 }
 
-template <class T>
-void BinaryReader<T>::setData(const T* address, const std::size_t sizeInBytes) {
+template <class T, class ByteOrder, class BitOrder>
+void BinaryReader<T, ByteOrder, BitOrder>::setData(const T* address, const std::size_t sizeInBytes) {
 	assert(nullptr != address);
 	m_remainDataSize = multiplyBy8(static_cast<uint64_t>(sizeInBytes));
 	m_cache = 0;
 	m_typedData = reinterpret_cast<const uint8_t*>(address);
 	m_bitPos = 0;
+	m_groupOffset = 0;
+	m_error = false;
 	updateCache();
 	resetReadBitsCount();
 }
 
-template <class T>
-bool BinaryReader<T>::readBits(std::size_t count, std::size_t& value) {
+template <class T, class ByteOrder, class BitOrder>
+bool BinaryReader<T, ByteOrder, BitOrder>::readBits(std::size_t count, std::size_t& value) {
 	if (static_cast<uint64_t>(count) > m_remainDataSize || count > BITNESS) {
+		m_error = true;
 		return false;
 	}
 	if (count + m_bitPos > BITNESS) {
@@ -179,8 +270,8 @@ bool BinaryReader<T>::readBits(std::size_t count, std::size_t& value) {
 	return true;
 }
 
-template <class T>
-bool BinaryReader<T>::lookBits(std::size_t count, std::size_t& value) const {
+template <class T, class ByteOrder, class BitOrder>
+bool BinaryReader<T, ByteOrder, BitOrder>::lookBits(std::size_t count, std::size_t& value) const {
 	if (static_cast<uint64_t>(count) > m_remainDataSize || count > BITNESS) {
 		return false;
 	}
@@ -194,7 +285,9 @@ bool BinaryReader<T>::lookBits(std::size_t count, std::size_t& value) const {
 		}
 		std::size_t tmpCache;
 		if (m_remainDataSize + m_bitPos < static_cast<uint64_t>(BITNESS << 1)) {
-			tmpCache = getBytes(m_typedData, static_cast<std::size_t>(divideBy8(m_bitPos + m_remainDataSize - BITNESS)));
+			const auto tailSize = static_cast<std::size_t>(divideBy8(m_bitPos + m_remainDataSize - BITNESS));
+			// the tail is placed at the low bytes of the cache as updateCache() does
+			tmpCache = (m_typedData ? getNextBytes(m_typedData, tailSize, tailSize) : getNextBytes(m_vData, tailSize, tailSize)) << multiplyBy8(sizeof(std::size_t) - tailSize);
 		}
 		else {
 			tmpCache = lookNextCache();
@@ -207,88 +300,346 @@ bool BinaryReader<T>::lookBits(std::size_t count, std::size_t& value) const {
 	return true;
 }
 
-template <class T>
-bool BinaryReader<T>::skipBits(const std::size_t count) {
+template <class T, class ByteOrder, class BitOrder>
+bool BinaryReader<T, ByteOrder, BitOrder>::skipBits(const std::size_t count) {
 	if (static_cast<uint64_t>(count) > m_remainDataSize) {
+		m_error = true;
 		return false;
 	}
 	if (count + m_bitPos > BITNESS) {
-		auto bitsFromNextCache = static_cast<uint16_t>(count - (BITNESS - m_bitPos));
+		auto bitsFromNextCache = count - (BITNESS - m_bitPos);
 		// skip bytes count in bits
 		const auto skipBitsAlignedSizeT = bitsFromNextCache & ~LITTLE_BITS[ALIGN_BY_SIZE_T];
 		bitsFromNextCache %= BITNESS;
+		// the size of the next cache is counted from the data remaining after the skipped words
+		m_remainDataSize -= static_cast<uint64_t>(skipBitsAlignedSizeT);
 		// skip bits count if from last not full byte
 		updateFarCache(skipBitsAlignedSizeT);
-		m_bitPos += bitsFromNextCache;
+		m_bitPos += static_cast<uint16_t>(bitsFromNextCache);
+		m_remainDataSize -= static_cast<uint64_t>(count - skipBitsAlignedSizeT);
 	}
 	else {
 		m_bitPos += static_cast<uint16_t>(count);
+		m_remainDataSize -= static_cast<uint64_t>(count);
 	}
-	m_remainDataSize -= static_cast<uint64_t>(count);
 	m_readBitsCount += count;
 	return true;
 }
 
-template<class T>
-inline T* BinaryReader<T>::getCurrentDataPtr() {
-	return (T*)(m_typedData - m_lastCacheSize + m_bitPos / 8);
+template <class T, class ByteOrder, class BitOrder>
+inline std::size_t BinaryReader<T, ByteOrder, BitOrder>::readBits(const std::size_t count) {
+	std::size_t value;
+	return readBits(count, value) ? value : 0;
 }
 
-template<class T>
-inline VirtualPointer<T> BinaryReader<T>::getCurrentVirtualDataPtr() {
-	return m_vData - m_lastCacheSize + (m_bitPos / 8 / sizeof(T));
+template <class T, class ByteOrder, class BitOrder>
+inline std::size_t BinaryReader<T, ByteOrder, BitOrder>::lookBits(const std::size_t count) const {
+	std::size_t value;
+	return lookBits(count, value) ? value : 0;
 }
 
-template<class T>
-inline std::size_t BinaryReader<T>::getReadBitsCount() const
-{
-	return m_readBitsCount;
+template <class T, class ByteOrder, class BitOrder>
+inline bool BinaryReader<T, ByteOrder, BitOrder>::hasError() const {
+	return m_error;
 }
 
-template<class T>
-inline void BinaryReader<T>::resetReadBitsCount() {
-	m_readBitsCount = 0;
+template <class T, class ByteOrder, class BitOrder>
+inline void BinaryReader<T, ByteOrder, BitOrder>::clearError() {
+	m_error = false;
 }
 
-template <class T>
-std::size_t BinaryReader<T>::getBytes(const uint8_t* from, std::size_t count) const {
-	std::size_t out = 0;
-	if (m_reverseBytes) {
-		if (!m_reverseBits) {
-			for (std::size_t i = 0; i < count; ++i) {
-				out <<= BITS_IN_BYTE;
-				out |= from[i] & LITTLE_BITS[BITS_IN_BYTE];
+template <class T, class ByteOrder, class BitOrder>
+template <class V>
+bool BinaryReader<T, ByteOrder, BitOrder>::readUE(V& value) {
+	static_assert(std::is_integral<V>::value, "ReadUE allows only integral types");
+	if (m_bitPos < BITNESS) {
+		// fast path: the whole code lies in the cache
+		const std::size_t bits = m_cache << m_bitPos;
+		if (bits) {
+			const std::size_t codeSize = (countLeadingZeros(bits) << 1) + 1;
+			if (codeSize <= BITNESS - m_bitPos) {
+				value = static_cast<V>((bits >> (BITNESS - codeSize)) - 1);
+				skipBitsUnchecked(codeSize);
+				return true;
 			}
 		}
+	}
+	// the code crosses the cache, the leading zero bits are looked through the next cache
+	const auto lookSize = static_cast<std::size_t>(std::min(static_cast<uint64_t>(BITNESS >> 1), m_remainDataSize));
+	std::size_t bits;
+	if (!lookSize || !lookBits(lookSize, bits) || !bits) {
+		m_error = true;
+		return false;
+	}
+	const std::size_t leadingZeros = countLeadingZeros(bits) - (BITNESS - lookSize);
+	if (static_cast<uint64_t>((leadingZeros << 1) + 1) > m_remainDataSize) {
+		m_error = true;
+		return false;
+	}
+	skipBits(leadingZeros);
+	readBits(leadingZeros + 1, bits);
+	value = static_cast<V>(bits - 1);
+	return true;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+template <class V>
+bool BinaryReader<T, ByteOrder, BitOrder>::readSE(V& value) {
+	static_assert(std::is_integral<V>::value && std::is_signed<V>::value, "ReadSE allows only signed integral types");
+	std::size_t codeNum;
+	if (!readUE(codeNum)) {
+		return false;
+	}
+	// 1, 2, 3, 4 ... are mapped to 1, -1, 2, -2 ...
+	const auto magnitude = static_cast<V>((codeNum + 1) >> 1);
+	value = (codeNum & 1) ? magnitude : static_cast<V>(-magnitude);
+	return true;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+constexpr std::size_t BinaryReader<T, ByteOrder, BitOrder>::REFILLED_BITS;
+
+template <class T, class ByteOrder, class BitOrder>
+void BinaryReader<T, ByteOrder, BitOrder>::refill() {
+	countStatistic(&HotPathStatistics::cacheRefills);
+	// the byte of the current bit is the first not fully read byte of the cache
+	const std::size_t unreadCacheBytes = getUnreadCacheBytes();
+	const auto bitInByte = static_cast<uint16_t>(m_bitPos & LITTLE_BITS[3]);
+	const uint64_t remainBitsFromByte = m_remainDataSize + bitInByte;
+	std::size_t count = sizeof(std::size_t);
+	if (remainBitsFromByte < static_cast<uint64_t>(BITNESS)) {
+		count = static_cast<std::size_t>(divideBy8(remainBitsFromByte));
+		if (!count) {
+			return;
+		}
+	}
+	if (ByteOrder::get(m_reverseBytes)) {
+		// the cache is loaded again from the byte of the current bit
+		if (m_typedData) {
+			m_typedData -= unreadCacheBytes;
+			m_cache = getBytes(m_typedData, count);
+			m_typedData += count;
+		}
 		else {
-			for (std::size_t i = 0; i < count; ++i) {
-				out <<= BITS_IN_BYTE;
-				out |= reverseBitsInByte(from[i] & LITTLE_BITS[BITS_IN_BYTE]);
-			}
+			m_vData -= unreadCacheBytes;
+			m_cache = getBytes(m_vData, count);
+			m_vData += count;
 		}
 	}
 	else {
-		if (!m_reverseBits) {
-			for (std::size_t i = 1; i <= count; ++i) {
-				out <<= BITS_IN_BYTE;
-				out |= from[count - i] & LITTLE_BITS[BITS_IN_BYTE];
-			}
+		// the bytes of the groups are reversed, so the unread bytes are kept and the next bytes are appended to them
+		const std::size_t nextCount = count - unreadCacheBytes;
+		const uint64_t bytesAfterCache = divideBy8(remainBitsFromByte) - unreadCacheBytes;
+		const std::size_t unreadBytes = unreadCacheBytes ? m_cache << multiplyBy8(nextCount) : 0;
+		if (m_typedData) {
+			m_cache = unreadBytes | getNextBytes(m_typedData, nextCount, bytesAfterCache);
+			moveNextBytes(m_typedData, nextCount, bytesAfterCache);
 		}
 		else {
-			for (std::size_t i = 1; i <= count; ++i) {
-				out <<= BITS_IN_BYTE;
-				out |= reverseBitsInByte(from[count - i] & LITTLE_BITS[BITS_IN_BYTE]);
+			m_cache = unreadBytes | getNextBytes(m_vData, nextCount, bytesAfterCache);
+			moveNextBytes(m_vData, nextCount, bytesAfterCache);
+		}
+	}
+	m_lastCacheSize = count;
+	m_bitPos = static_cast<uint16_t>(multiplyBy8(sizeof(std::size_t) - count)) + bitInByte;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline std::size_t BinaryReader<T, ByteOrder, BitOrder>::getCachedBitsCount() const {
+	return BITNESS - m_bitPos;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline std::size_t BinaryReader<T, ByteOrder, BitOrder>::lookBitsUnchecked(const std::size_t count) const {
+	assert(count <= getCachedBitsCount() && count < BITNESS);
+	// the shift is BITNESS only for zero bits of the full cache, they are masked out
+	return (m_cache >> ((BITNESS - m_bitPos - count) & (BITNESS - 1))) & LITTLE_BITS[count];
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline std::size_t BinaryReader<T, ByteOrder, BitOrder>::readBitsUnchecked(const std::size_t count) {
+	const std::size_t value = lookBitsUnchecked(count);
+	skipBitsUnchecked(count);
+	return value;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline void BinaryReader<T, ByteOrder, BitOrder>::skipBitsUnchecked(const std::size_t count) {
+	assert(count <= getCachedBitsCount());
+	m_bitPos += static_cast<uint16_t>(count);
+	m_remainDataSize -= static_cast<uint64_t>(count);
+	m_readBitsCount += count;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+bool BinaryReader<T, ByteOrder, BitOrder>::readPackedArray(const std::size_t width, std::size_t count, uint32_t* values, const BitPacking packing) {
+	const bool lsbFirst = BitPacking::LSB_FIRST == packing;
+	const uint64_t bitsCount = static_cast<uint64_t>(width) * count;
+	if (!width || width > MAX_PACKED_WIDTH || (lsbFirst && (m_bitPos & LITTLE_BITS[3]))
+		|| (lsbFirst ? multiplyBy8(divideBy8(bitsCount + 7)) : bitsCount) > m_remainDataSize) {
+		m_error = true;
+		return false;
+	}
+	const bool memoryOrder = ByteOrder::get(m_reverseBytes) && !BitOrder::get(m_reverseBits);
+	while (count) {
+		std::size_t unpacked = memoryOrder ? unpackContiguousValues(width, count, values, packing) : 0;
+		if (!unpacked) {
+			// the values crossing the chunks or the data in other orders
+			if (lsbFirst) {
+				unpacked = readLsbFirstGroup(width, count, values);
+			}
+			else {
+				readBits(width, *values);
+				unpacked = 1;
 			}
 		}
+		values += unpacked;
+		count -= unpacked;
 	}
-	return out;
+	return true;
 }
 
-template <class T>
-std::size_t BinaryReader<T>::getBytes(VirtualPointer<T> from, const std::size_t count) const {
+template <class T, class ByteOrder, class BitOrder>
+std::size_t BinaryReader<T, ByteOrder, BitOrder>::unpackContiguousValues(const std::size_t width, const std::size_t count, uint32_t* values, const BitPacking packing) {
+	const std::size_t bitInByte = m_bitPos & LITTLE_BITS[3];
+	const std::size_t unreadCacheBytes = getUnreadCacheBytes();
+	// the bytes from the byte of the current bit to the end of the data
+	const uint64_t remainBytes = divideBy8(m_remainDataSize + bitInByte);
+	const uint8_t* data;
+	uint64_t availableBytes = remainBytes;
+	if (m_typedData) {
+		data = m_typedData - unreadCacheBytes;
+	}
+	else {
+		// the elements of the wider types are not the bytes of the packed values
+		if (sizeof(T) != 1) {
+			return 0;
+		}
+		std::size_t elementsCount;
+		const T* chunk = (m_vData - unreadCacheBytes).contiguousData(elementsCount);
+		if (nullptr == chunk) {
+			return 0;
+		}
+		data = reinterpret_cast<const uint8_t*>(chunk);
+		availableBytes = std::min(availableBytes, static_cast<uint64_t>(elementsCount));
+	}
+	std::size_t valuesCount = static_cast<std::size_t>(std::min(static_cast<uint64_t>(count), (multiplyBy8(availableBytes) - bitInByte) / width));
+	const bool lsbFirst = BitPacking::LSB_FIRST == packing;
+	if (lsbFirst && valuesCount < count) {
+		// eight values take whole bytes, so the next values begin at the first bit of a byte
+		valuesCount -= valuesCount & LITTLE_BITS[3];
+	}
+	if (!valuesCount) {
+		return 0;
+	}
+	unpackBits(data, bitInByte, width, valuesCount, values, packing);
+	const std::size_t bitsCount = valuesCount * width;
+	skipBits(lsbFirst ? multiplyBy8(divideBy8(bitsCount + 7)) : bitsCount);
+	return valuesCount;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+std::size_t BinaryReader<T, ByteOrder, BitOrder>::readLsbFirstGroup(const std::size_t width, const std::size_t count, uint32_t* values) {
+	const std::size_t valuesCount = std::min<std::size_t>(count, BITS_IN_BYTE);
+	const std::size_t bytesCount = static_cast<std::size_t>(divideBy8(valuesCount * width + 7));
+	uint8_t bytes[MAX_PACKED_WIDTH];
+	for (std::size_t i = 0; i < bytesCount; ++i) {
+		readBits(BITS_IN_BYTE, bytes[i]);
+	}
+	unpackBits(bytes, 0, width, valuesCount, values, BitPacking::LSB_FIRST);
+	return valuesCount;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+bool BinaryReader<T, ByteOrder, BitOrder>::readView(const std::size_t sizeInBytes, VirtualPointer<T>& view) {
+	static_assert(ByteOrder::get(REVERSE_BYTES), "The view of the data is in the order of the memory");
+	if (!ByteOrder::get(m_reverseBytes) || m_bitPos & LITTLE_BITS[3] || multiplyBy8(static_cast<uint64_t>(sizeInBytes)) > m_remainDataSize) {
+		m_error = true;
+		return false;
+	}
+	view.clear();
+	if (sizeInBytes) {
+		const std::size_t unreadCacheBytes = getUnreadCacheBytes();
+		if (m_typedData) {
+			// the view is only read as the data of the reader
+			view.addChunk(const_cast<T*>(reinterpret_cast<const T*>(m_typedData - unreadCacheBytes)), sizeInBytes / sizeof(T));
+		}
+		else {
+			// every element of the virtual data holds one byte
+			view.addChunk(m_vData - unreadCacheBytes, sizeInBytes);
+		}
+	}
+	skipBits(multiplyBy8(sizeInBytes));
+	return true;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline typename BinaryReader<T, ByteOrder, BitOrder>::Checkpoint BinaryReader<T, ByteOrder, BitOrder>::mark() const {
+	return Checkpoint{ m_typedData, m_vData.getPosition(), m_lastCacheSize, m_groupOffset, m_remainDataSize, m_cache, m_bitPos, m_readBitsCount, m_error };
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline void BinaryReader<T, ByteOrder, BitOrder>::rewind(const Checkpoint& checkpoint) {
+	m_typedData = checkpoint.typedData;
+	if (!m_typedData) {
+		m_vData.setPosition(checkpoint.vDataPosition);
+	}
+	m_lastCacheSize = checkpoint.lastCacheSize;
+	m_groupOffset = checkpoint.groupOffset;
+	m_remainDataSize = checkpoint.remainDataSize;
+	m_cache = checkpoint.cache;
+	m_bitPos = checkpoint.bitPos;
+	m_readBitsCount = checkpoint.readBitsCount;
+	m_error = checkpoint.error;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline std::size_t BinaryReader<T, ByteOrder, BitOrder>::getUnreadCacheBytes() const {
+	return sizeof(std::size_t) - divideBy8(m_bitPos);
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline T* BinaryReader<T, ByteOrder, BitOrder>::getCurrentDataPtr() {
+	return (T*)(m_typedData - m_lastCacheSize + m_bitPos / 8);
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline VirtualPointer<T> BinaryReader<T, ByteOrder, BitOrder>::getCurrentVirtualDataPtr() {
+	return m_vData - m_lastCacheSize + (m_bitPos / 8);
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline std::size_t BinaryReader<T, ByteOrder, BitOrder>::getReadBitsCount() const
+{
+	return m_readBitsCount;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline void BinaryReader<T, ByteOrder, BitOrder>::resetReadBitsCount() {
+	m_readBitsCount = 0;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline std::size_t BinaryReader<T, ByteOrder, BitOrder>::orderWord(std::size_t word) const {
+	if (ByteOrder::get(m_reverseBytes)) {
+		word = reverseBytes(word);
+	}
+	if (BitOrder::get(m_reverseBits)) {
+		word = reverseBits(word);
+	}
+	return word;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+std::size_t BinaryReader<T, ByteOrder, BitOrder>::getBytes(const uint8_t* from, std::size_t count) const {
+	if (sizeof(std::size_t) == count) {
+		std::size_t word;
+		std::memcpy(&word, from, sizeof(std::size_t));
+		return orderWord(word);
+	}
 	std::size_t out = 0;
-	if (m_reverseBytes) {
-		if (!m_reverseBits) {
+	if (ByteOrder::get(m_reverseBytes)) {
+		if (!BitOrder::get(m_reverseBits)) {
 			for (std::size_t i = 0; i < count; ++i) {
 				out <<= BITS_IN_BYTE;
 				out |= from[i] & LITTLE_BITS[BITS_IN_BYTE];
@@ -302,7 +653,7 @@ std::size_t BinaryReader<T>::getBytes(VirtualPointer<T> from, const std::size_t
 		}
 	}
 	else {
-		if (!m_reverseBits) {
+		if (!BitOrder::get(m_reverseBits)) {
 			for (std::size_t i = 1; i <= count; ++i) {
 				out <<= BITS_IN_BYTE;
 				out |= from[count - i] & LITTLE_BITS[BITS_IN_BYTE];
@@ -318,14 +669,54 @@ std::size_t BinaryReader<T>::getBytes(VirtualPointer<T> from, const std::size_t
 	return out;
 }
 
-template <class T>
-void BinaryReader<T>::updateCache() {
+template <class T, class ByteOrder, class BitOrder>
+std::size_t BinaryReader<T, ByteOrder, BitOrder>::getBytes(const VirtualPointer<T>& from, const std::size_t count) const {
+	std::size_t available;
+	const T* data = from.contiguousData(available);
+	if (sizeof(T) == 1 && nullptr != data && available >= count) {
+		return getBytes(reinterpret_cast<const uint8_t*>(data), count);
+	}
+	countStatistic(&HotPathStatistics::slowPaths);
+	uint8_t bytes[sizeof(std::size_t)];
+	if (sizeof(T) == 1) {
+		memcpy(bytes, from, count);
+	}
+	else {
+		// every element of the virtual data holds one byte in its lowest bits
+		for (std::size_t i = 0; i < count; ++i) {
+			bytes[i] = static_cast<uint8_t>(from[i] & LITTLE_BITS[BITS_IN_BYTE]);
+		}
+	}
+	return getBytes(bytes, count);
+}
+
+template <class T, class ByteOrder, class BitOrder>
+void BinaryReader<T, ByteOrder, BitOrder>::updateCache() {
+	countStatistic(&HotPathStatistics::cacheRefills);
+	if (m_groupOffset) {
+		// the next cache begins inside the group taken in part by refill()
+		countStatistic(&HotPathStatistics::slowPaths);
+		const uint64_t bytesAfterCache = divideBy8(m_bitPos + m_remainDataSize - BITNESS);
+		const auto nextCount = static_cast<std::size_t>(std::min(static_cast<uint64_t>(sizeof(std::size_t)), bytesAfterCache));
+		if (m_typedData) {
+			m_cache = getNextBytes(m_typedData, nextCount, bytesAfterCache);
+			moveNextBytes(m_typedData, nextCount, bytesAfterCache);
+		}
+		else {
+			m_cache = getNextBytes(m_vData, nextCount, bytesAfterCache);
+			moveNextBytes(m_vData, nextCount, bytesAfterCache);
+		}
+		m_lastCacheSize = nextCount;
+		m_bitPos = static_cast<uint16_t>(multiplyBy8(sizeof(std::size_t) - nextCount));
+		return;
+	}
 	std::size_t count;
 	if (m_bitPos + m_remainDataSize >= static_cast<uint64_t>(BITNESS) * 2) {
 		count = sizeof(std::size_t);
 	}
 	else {
 		count = static_cast<std::size_t>(divideBy8((m_bitPos + m_remainDataSize) % BITNESS));
+		countStatistic(&HotPathStatistics::slowPaths);
 	}
 	if (m_typedData) {
 		m_cache = getBytes(m_typedData, count);
@@ -340,30 +731,63 @@ void BinaryReader<T>::updateCache() {
 	m_bitPos = static_cast<uint16_t>(multiplyBy8(sizeof(std::size_t) - count));
 }
 
-template <class T>
-void BinaryReader<T>::updateFarCache()
+template <class T, class ByteOrder, class BitOrder>
+void BinaryReader<T, ByteOrder, BitOrder>::updateFarCache()
 {
 	updateFarCache(0);
 }
 
-template <class T>
-void BinaryReader<T>::updateFarCache(std::size_t skipBitsAlignedSizeT) {
+template <class T, class ByteOrder, class BitOrder>
+void BinaryReader<T, ByteOrder, BitOrder>::updateFarCache(std::size_t skipBitsAlignedSizeT) {
+	countStatistic(&HotPathStatistics::seeks);
 	// += 1 increase pointer on sizeof(std::size_t) bytes
 	if (m_typedData) {
 		m_typedData += ((divideBy8(skipBitsAlignedSizeT)));
 	}
 	else {
-		m_vData += ((divideBy8(skipBitsAlignedSizeT)) / sizeof(T));
+		m_vData += divideBy8(skipBitsAlignedSizeT);
 	}
 	updateCache();
 }
 
-template <class T>
-std::size_t BinaryReader<T>::lookNextCache() const {
-	const auto availableBytesForPutIntoCache = static_cast<std::size_t>(divideBy8(m_remainDataSize + multiplyBy8(sizeof(std::size_t)) - m_bitPos));
-	const auto bytesToCopyCount = std::min(sizeof(std::size_t), availableBytesForPutIntoCache);
+template <class T, class ByteOrder, class BitOrder>
+std::size_t BinaryReader<T, ByteOrder, BitOrder>::lookNextCache() const {
+	countStatistic(&HotPathStatistics::slowPaths);
+	const uint64_t bytesAfterCache = divideBy8(m_bitPos + m_remainDataSize - BITNESS);
+	const auto bytesToCopyCount = static_cast<std::size_t>(std::min(static_cast<uint64_t>(sizeof(std::size_t)), bytesAfterCache));
 	if (m_typedData) {
-		return getBytes(m_typedData, bytesToCopyCount);
+		return getNextBytes(m_typedData, bytesToCopyCount, bytesAfterCache);
+	}
+	return getNextBytes(m_vData, bytesToCopyCount, bytesAfterCache);
+}
+
+template <class T, class ByteOrder, class BitOrder>
+template <class Pointer>
+std::size_t BinaryReader<T, ByteOrder, BitOrder>::getNextBytes(const Pointer& from, const std::size_t count, const uint64_t bytesAfterCache) const {
+	const auto groupSize = static_cast<std::size_t>(std::min(static_cast<uint64_t>(sizeof(std::size_t)), m_groupOffset + bytesAfterCache));
+	if (!m_groupOffset && count == groupSize) {
+		return getBytes(from, count);
+	}
+	assert(!ByteOrder::get(m_reverseBytes));
+	// the first bytes of a reversed group lie at its end in the memory
+	const std::size_t firstCount = std::min(count, groupSize - m_groupOffset);
+	std::size_t out = getBytes(from + (groupSize - m_groupOffset - firstCount), firstCount);
+	if (firstCount < count) {
+		const std::size_t nextCount = count - firstCount;
+		const auto nextGroupSize = static_cast<std::size_t>(std::min(static_cast<uint64_t>(sizeof(std::size_t)), bytesAfterCache - firstCount));
+		out = (out << multiplyBy8(nextCount)) | getBytes(from + (groupSize + nextGroupSize - nextCount), nextCount);
+	}
+	return out;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+template <class Pointer>
+void BinaryReader<T, ByteOrder, BitOrder>::moveNextBytes(Pointer& from, const std::size_t count, const uint64_t bytesAfterCache) {
+	const auto groupSize = static_cast<std::size_t>(std::min(static_cast<uint64_t>(sizeof(std::size_t)), m_groupOffset + bytesAfterCache));
+	if (m_groupOffset + count < groupSize) {
+		m_groupOffset += count;
+		return;
 	}
-	return getBytes(m_vData, bytesToCopyCount);
+	from += groupSize;
+	m_groupOffset = m_groupOffset + count - groupSize;
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "BinaryReader.h"
+#include "BinaryWriter.h"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+// returns the sum of the widths of the fields
+template <std::size_t... WIDTHS>
+constexpr std::size_t sumBitWidths() {
+	const std::size_t widths[] = { WIDTHS... };
+	std::size_t bits = 0;
+	for (const std::size_t width : widths) {
+		bits += width;
+	}
+	return bits;
+}
+
+// A fixed layout of bit fields declared by their widths in the order of the data,
+// for example BitLayout<8, 1, 1, 1, 13, 2, 2, 4> for the header of an MPEG-TS packet.
+// All the fields are read by one readBits() of the whole layout and extracted by shifts and masks
+// known at compile time, so the bounds and the cache are checked once per layout instead of once per field.
+// The layout must not be longer than the machine word.
+template <std::size_t... WIDTHS>
+struct BitLayout final {
+	static constexpr std::size_t FIELDS_COUNT = sizeof...(WIDTHS);
+	static constexpr std::size_t TOTAL_BITS = sumBitWidths<WIDTHS...>();
+
+	static_assert(FIELDS_COUNT > 0, "The layout must contain fields");
+	static_assert(TOTAL_BITS > 0 && TOTAL_BITS <= multiplyBy8(sizeof(std::size_t)), "The layout must fit the machine word");
+
+	using Fields = std::array<std::size_t, FIELDS_COUNT>;
+
+	// the field I of the word containing the whole layout in its low TOTAL_BITS bits
+	template <std::size_t I>
+	static constexpr std::size_t get(std::size_t word);
+	static Fields unpack(std::size_t word);
+	// the values of the fields are cut to their widths
+	static std::size_t pack(const Fields& fields);
+
+	// Return false and do not move the position if the data is over.
+	template <class T, class ByteOrder, class BitOrder>
+	static bool read(BinaryReader<T, ByteOrder, BitOrder>& reader, Fields& fields);
+	template <class T>
+	static bool write(BinaryWriter<T>& writer, const Fields& fields);
+
+private:
+	static constexpr std::size_t width(std::size_t idx);
+	// the position of the lowest bit of the field idx in the word of the layout
+	static constexpr std::size_t shift(std::size_t idx);
+
+	template <std::size_t... I>
+	static Fields unpack(std::size_t word, std::index_sequence<I...>);
+	template <std::size_t... I>
+	static std::size_t pack(const Fields& fields, std::index_sequence<I...>);
+};
+
+template <std::size_t... WIDTHS>
+constexpr std::size_t BitLayout<WIDTHS...>::FIELDS_COUNT;
+
+template <std::size_t... WIDTHS>
+constexpr std::size_t BitLayout<WIDTHS...>::TOTAL_BITS;
+
+template <std::size_t... WIDTHS>
+constexpr std::size_t BitLayout<WIDTHS...>::width(const std::size_t idx) {
+	const std::size_t widths[] = { WIDTHS... };
+	return widths[idx];
+}
+
+template <std::size_t... WIDTHS>
+constexpr std::size_t BitLayout<WIDTHS...>::shift(const std::size_t idx) {
+	std::size_t bits = 0;
+	for (std::size_t i = 0; i <= idx; ++i) {
+		bits += width(i);
+	}
+	return TOTAL_BITS - bits;
+}
+
+template <std::size_t... WIDTHS>
+template <std::size_t I>
+constexpr std::size_t BitLayout<WIDTHS...>::get(const std::size_t word) {
+	static_assert(I < sizeof...(WIDTHS), "There is no such field in the layout");
+	return (word >> shift(I)) & LITTLE_BITS[width(I)];
+}
+
+template <std::size_t... WIDTHS>
+inline typename BitLayout<WIDTHS...>::Fields BitLayout<WIDTHS...>::unpack(const std::size_t word) {
+	return unpack(word, std::make_index_sequence<sizeof...(WIDTHS)>());
+}
+
+template <std::size_t... WIDTHS>
+template <std::size_t... I>
+inline typename BitLayout<WIDTHS...>::Fields BitLayout<WIDTHS...>::unpack(const std::size_t word, std::index_sequence<I...>) {
+	return Fields{ { get<I>(word)... } };
+}
+
+template <std::size_t... WIDTHS>
+inline std::size_t BitLayout<WIDTHS...>::pack(const Fields& fields) {
+	return pack(fields, std::make_index_sequence<sizeof...(WIDTHS)>());
+}
+
+template <std::size_t... WIDTHS>
+template <std::size_t... I>
+inline std::size_t BitLayout<WIDTHS...>::pack(const Fields& fields, std::index_sequence<I...>) {
+	std::size_t word = 0;
+	const std::size_t parts[] = { ((fields[I] & LITTLE_BITS[width(I)]) << shift(I))... };
+	for (const std::size_t part : parts) {
+		word |= part;
+	}
+	return word;
+}
+
+template <std::size_t... WIDTHS>
+template <class T, class ByteOrder, class BitOrder>
+inline bool BitLayout<WIDTHS...>::read(BinaryReader<T, ByteOrder, BitOrder>& reader, Fields& fields) {
+	std::size_t word;
+	if (!reader.readBits(TOTAL_BITS, word)) {
+		return false;
+	}
+	fields = unpack(word);
+	return true;
+}
+
+template <std::size_t... WIDTHS>
+template <class T>
+inline bool BitLayout<WIDTHS...>::write(BinaryWriter<T>& writer, const Fields& fields) {
+	return writer.writeBits(TOTAL_BITS, pack(fields));
+}
@@ -2,6 +2,10 @@
 
 #include <cstddef>
 
+#if _WIN32
+#include <intrin.h>
+#endif
+
 #if defined(_M_X64) || defined(__amd64__)
 constexpr std::size_t ALIGN_BY_SIZE_T = 6;
 constexpr std::size_t LITTLE_BITS[65] = {
@@ -36,4 +40,64 @@ constexpr std::size_t LITTLE_BITS[33] = {
 	0x1FFFFFF,	0x3FFFFFF,	0x7FFFFFF,	0xFFFFFFF,
 	0x1FFFFFFF,	0x3FFFFFFF,	0x7FFFFFFF,	0xFFFFFFFF
 };
-#endif
\ No newline at end of file
+#endif
+
+// returns the count of zero bits before the most significant one bit, the value must not be zero
+#if _WIN32
+
+#if defined(_M_X64) || defined(__amd64__)
+inline std::size_t countLeadingZeros(const std::size_t value) {
+	unsigned long idx;
+	_BitScanReverse64(&idx, value);
+	return 63 - idx;
+}
+#else
+inline std::size_t countLeadingZeros(const std::size_t value) {
+	unsigned long idx;
+	_BitScanReverse(&idx, value);
+	return 31 - idx;
+}
+#endif
+
+#else
+#if defined(_M_X64) || defined(__amd64__)
+inline std::size_t countLeadingZeros(const std::size_t value) {
+	return static_cast<std::size_t>(__builtin_clzll(value));
+}
+#else
+inline std::size_t countLeadingZeros(const std::size_t value) {
+	return static_cast<std::size_t>(__builtin_clz(value));
+}
+#endif
+
+#endif
+
+// returns the count of zero bits after the least significant one bit, the value must not be zero
+#if _WIN32
+
+#if defined(_M_X64) || defined(__amd64__)
+inline std::size_t countTrailingZeros(const std::size_t value) {
+	unsigned long idx;
+	_BitScanForward64(&idx, value);
+	return idx;
+}
+#else
+inline std::size_t countTrailingZeros(const std::size_t value) {
+	unsigned long idx;
+	_BitScanForward(&idx, value);
+	return idx;
+}
+#endif
+
+#else
+#if defined(_M_X64) || defined(__amd64__)
+inline std::size_t countTrailingZeros(const std::size_t value) {
+	return static_cast<std::size_t>(__builtin_ctzll(value));
+}
+#else
+inline std::size_t countTrailingZeros(const std::size_t value) {
+	return static_cast<std::size_t>(__builtin_ctz(value));
+}
+#endif
+
+#endif
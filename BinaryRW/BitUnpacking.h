@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// The order of the bits of the values packed one after another.
+enum class BitPacking {
+	// the bits are taken from the highest bit of every byte, the first taken bit is the highest bit of the value
+	// (as BinaryReader reads them by default)
+	MSB_FIRST,
+	// the bits are taken from the lowest bit of every byte, the first taken bit is the lowest bit of the value
+	// (as Parquet and ORC pack them)
+	LSB_FIRST
+};
+
+constexpr std::size_t MAX_PACKED_WIDTH = 32;
+
+// Unpacks count values of width bits (1 to MAX_PACKED_WIDTH) beginning at the bit bitOffset (0 to 7) of data,
+// bitOffset is counted in the order of the packing. Only the bytes containing the bits of the values are read.
+// Every width has its own kernel with the shifts and the masks known at compile time,
+// all the widths are unpacked by eight values at a time with SSSE3 shuffles when the processor has SSE4.1
+// (the values up to 25 bits in 32-bit lanes, the wider ones in 64-bit lanes).
+// The vector kernels are built on x86 for any target and chosen at runtime.
+void unpackBits(const uint8_t* data, std::size_t bitOffset, std::size_t width, std::size_t count, uint32_t* values, BitPacking packing);
+
+// returns true if unpackBits() uses the vector kernels on this processor
+bool hasVectorUnpacking();
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "BitMask.h"
+#include "Reverser.h"
+#include "VirtualPointer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// An immutable view of a bitstream for reading at arbitrary bit offsets without a reading position.
+// The bits are ordered as BinaryReader with the same orders reads them after setData with the same data.
+// The view keeps the offsets of the chunks of the data, so a read finds its chunk by binary search
+// in O(log chunks). The view is not changed by reading, so one view can be read by many threads simultaneously.
+// The data must be valid and must not be changed while the view is used.
+template <class T, class ByteOrder = RuntimeOrder, class BitOrder = RuntimeOrder>
+class BitstreamView final {
+public:
+	BitstreamView(const T* data, std::size_t sizeInBytes, reverse_bytes_t reverseBytes = REVERSE_BYTES, reverse_bits_t reverseBits = !REVERSE_BITS);
+	// Every element of the virtual data gives one byte of the data, its lowest one, as in BinaryReader,
+	// so the size counts the elements. The lowest bytes of the elements wider than a byte are copied to the view.
+	// std::out_of_range is thrown if the pointer has less than sizeInBytes elements
+	BitstreamView(const VirtualPointer<T>& data, std::size_t sizeInBytes, reverse_bytes_t reverseBytes = REVERSE_BYTES, reverse_bits_t reverseBits = !REVERSE_BITS);
+
+	// Reads count bits (not more than the machine word) from the bit bitOffset of the data.
+	// Returns false if the bits are beyond the data.
+	bool readBitsAt(uint64_t bitOffset, std::size_t count, std::size_t& value) const;
+
+	uint64_t getSizeInBits() const;
+
+private:
+	reverse_bytes_t m_reverseBytes;
+	reverse_bits_t m_reverseBits;
+	// the beginnings of the chunks and the offsets of their ends from the beginning of the data in bytes
+	std::vector<const uint8_t*> m_chunks;
+	std::vector<uint64_t> m_chunkEnds;
+	uint64_t m_sizeInBytes = 0;
+	// the lowest bytes of the elements of the virtual data wider than a byte, shared by the copies of the view
+	std::shared_ptr<const std::vector<uint8_t>> m_lowBytes;
+
+	void addChunk(const uint8_t* data, std::size_t sizeInBytes);
+	// returns the index of the chunk containing the byte
+	std::size_t findChunk(uint64_t byteIdx) const;
+	// returns the byte of the data, chunk is the index of the chunk of the previous byte
+	uint8_t getByte(uint64_t byteIdx, std::size_t& chunk) const;
+	// returns the index of the byte of the data containing the bits of the byteIdx-th byte of the stream:
+	// without reversing of the bytes the bytes of every group read at once by BinaryReader are reversed:
+	// machine words from the beginning of the data, the short group is the first one if the data is shorter than two words
+	uint64_t getDataByteIdx(uint64_t byteIdx) const;
+};
+
+template <class T, class ByteOrder, class BitOrder>
+BitstreamView<T, ByteOrder, BitOrder>::BitstreamView(const T* data, const std::size_t sizeInBytes, const reverse_bytes_t reverseBytes, const reverse_bits_t reverseBits) :
+	m_reverseBytes(reverseBytes),
+	m_reverseBits(reverseBits)
+{
+	addChunk(reinterpret_cast<const uint8_t*>(data), sizeInBytes);
+}
+
+template <class T, class ByteOrder, class BitOrder>
+BitstreamView<T, ByteOrder, BitOrder>::BitstreamView(const VirtualPointer<T>& data, const std::size_t sizeInBytes, const reverse_bytes_t reverseBytes, const reverse_bits_t reverseBits) :
+	m_reverseBytes(reverseBytes),
+	m_reverseBits(reverseBits)
+{
+	std::shared_ptr<std::vector<uint8_t>> lowBytes;
+	if (sizeof(T) != 1) {
+		lowBytes = std::make_shared<std::vector<uint8_t>>();
+		lowBytes->reserve(sizeInBytes);
+	}
+	VirtualPointer<T> chunk = data;
+	std::size_t remainDataSize = sizeInBytes;
+	while (remainDataSize) {
+		std::size_t count;
+		const T* chunkData = chunk.contiguousData(count);
+		if (nullptr == chunkData) {
+			throw std::out_of_range("Attempt to go abroad the memory");
+		}
+		const std::size_t chunkSize = std::min(count, remainDataSize);
+		if (sizeof(T) == 1) {
+			addChunk(reinterpret_cast<const uint8_t*>(chunkData), chunkSize);
+		}
+		else {
+			for (std::size_t i = 0; i < chunkSize; ++i) {
+				lowBytes->push_back(static_cast<uint8_t>(chunkData[i] & LITTLE_BITS[BITS_IN_BYTE]));
+			}
+		}
+		remainDataSize -= chunkSize;
+		chunk += count;
+	}
+	if (lowBytes) {
+		addChunk(lowBytes->data(), lowBytes->size());
+		m_lowBytes = std::move(lowBytes);
+	}
+}
+
+template <class T, class ByteOrder, class BitOrder>
+bool BitstreamView<T, ByteOrder, BitOrder>::readBitsAt(const uint64_t bitOffset, const std::size_t count, std::size_t& value) const {
+	constexpr std::size_t BITNESS = multiplyBy8(sizeof(std::size_t));
+	if (count > BITNESS || bitOffset > multiplyBy8(m_sizeInBytes) || count > multiplyBy8(m_sizeInBytes) - bitOffset) {
+		return false;
+	}
+	if (!count) {
+		value = 0;
+		return true;
+	}
+	const uint64_t firstByte = divideBy8(bitOffset);
+	std::size_t bitInByte = static_cast<std::size_t>(bitOffset & LITTLE_BITS[3]);
+	std::size_t chunk = findChunk(firstByte);
+	if (ByteOrder::get(m_reverseBytes) && bitInByte + count <= BITNESS && firstByte + sizeof(std::size_t) <= m_chunkEnds[chunk]) {
+		// the word containing all the bits lies inside one chunk
+		const uint64_t chunkBegin = chunk ? m_chunkEnds[chunk - 1] : 0;
+		std::size_t word;
+		std::memcpy(&word, m_chunks[chunk] + (firstByte - chunkBegin), sizeof(std::size_t));
+		word = reverseBytes(word);
+		if (BitOrder::get(m_reverseBits)) {
+			word = reverseBits(word);
+		}
+		value = (word << bitInByte) >> (BITNESS - count);
+		return true;
+	}
+	value = 0;
+	std::size_t remainBits = count;
+	for (uint64_t byteIdx = firstByte; remainBits; ++byteIdx, bitInByte = 0) {
+		uint8_t byte = getByte(getDataByteIdx(byteIdx), chunk);
+		if (BitOrder::get(m_reverseBits)) {
+			byte = reverseBitsInByte(byte);
+		}
+		const std::size_t availableBits = BITS_IN_BYTE - bitInByte;
+		const std::size_t bits = std::min(availableBits, remainBits);
+		value = (value << bits) | ((byte >> (availableBits - bits)) & LITTLE_BITS[bits]);
+		remainBits -= bits;
+	}
+	return true;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline uint64_t BitstreamView<T, ByteOrder, BitOrder>::getSizeInBits() const {
+	return multiplyBy8(m_sizeInBytes);
+}
+
+template <class T, class ByteOrder, class BitOrder>
+void BitstreamView<T, ByteOrder, BitOrder>::addChunk(const uint8_t* data, const std::size_t sizeInBytes) {
+	if (!sizeInBytes) {
+		return;
+	}
+	m_sizeInBytes += sizeInBytes;
+	m_chunks.push_back(data);
+	m_chunkEnds.push_back(m_sizeInBytes);
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline std::size_t BitstreamView<T, ByteOrder, BitOrder>::findChunk(const uint64_t byteIdx) const {
+	return static_cast<std::size_t>(std::upper_bound(m_chunkEnds.cbegin(), m_chunkEnds.cend(), byteIdx) - m_chunkEnds.cbegin());
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline uint8_t BitstreamView<T, ByteOrder, BitOrder>::getByte(const uint64_t byteIdx, std::size_t& chunk) const {
+	if (chunk >= m_chunks.size() || byteIdx >= m_chunkEnds[chunk] || (chunk && byteIdx < m_chunkEnds[chunk - 1])) {
+		chunk = findChunk(byteIdx);
+	}
+	const uint64_t chunkBegin = chunk ? m_chunkEnds[chunk - 1] : 0;
+	return m_chunks[chunk][byteIdx - chunkBegin];
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline uint64_t BitstreamView<T, ByteOrder, BitOrder>::getDataByteIdx(const uint64_t byteIdx) const {
+	if (ByteOrder::get(m_reverseBytes)) {
+		return byteIdx;
+	}
+	uint64_t wordBegin;
+	uint64_t wordSize;
+	if (m_sizeInBytes > sizeof(std::size_t) && m_sizeInBytes < 2 * sizeof(std::size_t)) {
+		// BinaryReader takes the short word first when the data is shorter than two words
+		const uint64_t firstWordSize = m_sizeInBytes - sizeof(std::size_t);
+		wordBegin = byteIdx < firstWordSize ? 0 : firstWordSize;
+		wordSize = byteIdx < firstWordSize ? firstWordSize : sizeof(std::size_t);
+	}
+	else {
+		wordBegin = byteIdx - byteIdx % sizeof(std::size_t);
+		wordSize = std::min<uint64_t>(sizeof(std::size_t), m_sizeInBytes - wordBegin);
+	}
+	return wordBegin + wordSize - 1 - (byteIdx - wordBegin);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+
+// A source of the bytes of a stream pulled by blocks, for example by StreamBinaryReader.
+class ByteSource {
+public:
+	virtual ~ByteSource() noexcept = default;
+
+	// Reads up to size bytes to buffer and returns the count of the read bytes, it can be less than size.
+	// Zero means the end of the stream. The errors of the source are thrown as exceptions.
+	virtual std::size_t read(uint8_t* buffer, std::size_t size) = 0;
+};
+
+// Pulls the bytes from a function with the same contract as ByteSource::read().
+class CallbackByteSource final : public ByteSource {
+public:
+	using Callback = std::function<std::size_t(uint8_t* buffer, std::size_t size)>;
+
+	explicit CallbackByteSource(Callback callback);
+
+	std::size_t read(uint8_t* buffer, std::size_t size) override;
+
+private:
+	Callback m_callback;
+};
+
+// Reads the bytes from a file descriptor (a file, a pipe or a socket), the descriptor is not closed.
+// std::system_error is thrown if the reading fails.
+class FileByteSource final : public ByteSource {
+public:
+	explicit FileByteSource(int fd);
+
+	std::size_t read(uint8_t* buffer, std::size_t size) override;
+
+private:
+	int m_fd;
+};
+
+// Reads the bytes from a stream opened in the binary mode.
+// std::ios_base::failure is thrown if the stream is bad after the reading.
+class StreamByteSource final : public ByteSource {
+public:
+	explicit StreamByteSource(std::istream& stream);
+
+	std::size_t read(uint8_t* buffer, std::size_t size) override;
+
+private:
+	std::istream& m_stream;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "VirtualPointer.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Removal of the emulation prevention bytes of H.264/HEVC NAL units without copying.
+// Every 0x03 byte following two zero bytes (0x000003) is an emulation prevention byte.
+// The function adds to rbsp the chunks of the NAL unit data between such bytes,
+// so the data of rbsp is the RBSP of the NAL unit. The scan uses SSE2 when it is available.
+// The NAL unit data must be valid while rbsp or its copies are used and must not be written through them.
+// Returns the size of the added RBSP in bytes.
+std::size_t addRbspChunks(VirtualPointer<uint8_t>& rbsp, const uint8_t* nal, std::size_t size);
+
+// returns the index of the first emulation prevention byte from the index from or size if there is no one
+std::size_t findEmulationPreventionByte(const uint8_t* nal, std::size_t from, std::size_t size);
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "BackwardBinaryReader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Decoding table of the finite state entropy (tANS) codes as in zstd.
+// The table is built from the normalized counts of the symbols: their sum is 1 << tableLog,
+// the count -1 marks a symbol with the probability less than 1 / (1 << tableLog).
+// The stream is read backward, the first read bits are the initial states, so it is decoded by BackwardBinaryReader.
+// Invalid counts cause std::invalid_argument.
+// The table is immutable after construction and can be used by several readers simultaneously.
+class FseTable final {
+public:
+	// the minimal table log of zstd, the step of the spread of the symbols is odd and visits all the states from it
+	static constexpr std::size_t MIN_TABLE_LOG = 5;
+	static constexpr std::size_t MAX_TABLE_LOG = 15;
+	static constexpr std::size_t MAX_SYMBOLS = 256;
+	static constexpr std::size_t MAX_STATES = 4;
+
+	FseTable(const int16_t* normalizedCounts, std::size_t symbolsCount, std::size_t tableLog);
+
+	// Skips the zero bits and the set bit that end the stream of zstd (they are the first read ones).
+	// Returns false if the last byte of the stream is zero.
+	template <class T, class BitOrder>
+	static bool skipPadding(BackwardBinaryReader<T, BitOrder>& reader);
+
+	// Decodes count symbols by STATES interleaved states: the symbol i is decoded by the state i % STATES,
+	// so the lookups of the states do not depend on one another and overlap in the pipeline.
+	// The initial states are read one after another, the states are not updated after their last symbols.
+	// A round of the states is decoded without checks when its longest codes fit the refilled cache
+	// (STATES * tableLog <= REFILLED_BITS of the reader).
+	// Returns false if the data is over, the symbols decoded before are written.
+	template <std::size_t STATES, class T, class BitOrder>
+	bool decode(BackwardBinaryReader<T, BitOrder>& reader, uint8_t* symbols, std::size_t count) const;
+
+	std::size_t getTableLog() const;
+
+private:
+	struct Entry final {
+		// the state after the symbol without the read bits
+		uint16_t baseState;
+		uint8_t symbol;
+		uint8_t bitsCount;
+	};
+
+	std::vector<Entry> m_entries;
+	std::size_t m_tableLog;
+};
+
+template <class T, class BitOrder>
+bool FseTable::skipPadding(BackwardBinaryReader<T, BitOrder>& reader) {
+	std::size_t lastByte;
+	if (!reader.lookBits(BITS_IN_BYTE, lastByte) || !lastByte) {
+		return false;
+	}
+	return reader.skipBits(countLeadingZeros(lastByte) - (multiplyBy8(sizeof(std::size_t)) - BITS_IN_BYTE) + 1);
+}
+
+template <std::size_t STATES, class T, class BitOrder>
+bool FseTable::decode(BackwardBinaryReader<T, BitOrder>& reader, uint8_t* symbols, const std::size_t count) const {
+	static_assert(STATES > 0 && STATES <= MAX_STATES, "The decoder interleaves from 1 to 4 states");
+	std::size_t states[STATES];
+	for (std::size_t& state : states) {
+		if (!reader.readBits(m_tableLog, state)) {
+			return false;
+		}
+	}
+	const std::size_t updatesCount = count > STATES ? count - STATES : 0;
+	const std::size_t roundBits = STATES * m_tableLog;
+	std::size_t idx = 0;
+	if (roundBits <= BackwardBinaryReader<T, BitOrder>::REFILLED_BITS) {
+		while (idx + STATES <= updatesCount) {
+			reader.refill();
+			if (reader.getCachedBitsCount() < roundBits) {
+				break;
+			}
+			for (std::size_t i = 0; i < STATES; ++i) {
+				const Entry& entry = m_entries[states[i]];
+				symbols[idx + i] = entry.symbol;
+				states[i] = entry.baseState + reader.readBitsUnchecked(entry.bitsCount);
+			}
+			idx += STATES;
+		}
+	}
+	// the tail of the data and the rounds that do not fit the cache
+	for (; idx < updatesCount; ++idx) {
+		std::size_t& state = states[idx % STATES];
+		const Entry& entry = m_entries[state];
+		std::size_t bits;
+		if (!reader.readBits(entry.bitsCount, bits)) {
+			return false;
+		}
+		symbols[idx] = entry.symbol;
+		state = entry.baseState + bits;
+	}
+	for (; idx < count; ++idx) {
+		symbols[idx] = m_entries[states[idx % STATES]].symbol;
+	}
+	return true;
+}
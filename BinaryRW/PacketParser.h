@@ -0,0 +1,165 @@
+#pragma once
+
+#include "BinaryReader.h"
+#include "ThreadPool.h"
+#include "VirtualPointer.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Parses the packets of packetSize bytes following one another on the pool, parse(reader, packetIdx) is called for every packet.
+// The results are in the order of the packets, the first exception thrown by parse is rethrown.
+// std::invalid_argument is thrown if packetSize is zero.
+template <class Result, class ByteOrder, class BitOrder, class Parse>
+std::vector<Result> parsePackets(ThreadPool& pool, const BinaryReader<uint8_t, ByteOrder, BitOrder>& prototype,
+	const uint8_t* data, std::size_t sizeInBytes, std::size_t packetSize, Parse parse, std::size_t batchSize = 0);
+
+// The same for the packets of a virtual pointer, they can cross the borders of the chunks.
+template <class Result, class ByteOrder, class BitOrder, class Parse>
+std::vector<Result> parsePackets(ThreadPool& pool, const BinaryReader<uint8_t, ByteOrder, BitOrder>& prototype,
+	const VirtualPointer<uint8_t>& data, std::size_t sizeInBytes, std::size_t packetSize, Parse parse, std::size_t batchSize = 0);
+
+// The batches queued by one call of parsePackets: they are counted apart from the other tasks of the pool,
+// so the call waits only for them, and the destructor waits for them, so they never outlive the results.
+class PacketBatches final {
+public:
+	PacketBatches() = default;
+	PacketBatches(const PacketBatches& other) = delete;
+	PacketBatches& operator=(const PacketBatches& other) = delete;
+	~PacketBatches() noexcept;
+
+	template <class Batch>
+	void run(ThreadPool& pool, Batch batch);
+	// waits for the queued batches and rethrows the first exception thrown by them
+	void wait();
+
+private:
+	std::mutex m_mutex;
+	std::condition_variable m_batchesDone;
+	std::size_t m_pendingBatches = 0;
+	std::exception_ptr m_exception;
+};
+
+inline PacketBatches::~PacketBatches() noexcept {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_batchesDone.wait(lock, [this]() { return !m_pendingBatches; });
+}
+
+template <class Batch>
+void PacketBatches::run(ThreadPool& pool, Batch batch) {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_pendingBatches;
+	}
+	try {
+		pool.run([this, batch]() {
+			std::exception_ptr exception;
+			try {
+				batch();
+			}
+			catch (...) {
+				exception = std::current_exception();
+			}
+			// notified under the lock, so the waiting call can not destroy the object before
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (exception && !m_exception) {
+				m_exception = exception;
+			}
+			if (!--m_pendingBatches) {
+				m_batchesDone.notify_all();
+			}
+		});
+	}
+	catch (...) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		--m_pendingBatches;
+		throw;
+	}
+}
+
+inline void PacketBatches::wait() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_batchesDone.wait(lock, [this]() { return !m_pendingBatches; });
+	if (m_exception) {
+		std::exception_ptr exception;
+		std::swap(exception, m_exception);
+		std::rethrow_exception(exception);
+	}
+}
+
+inline std::size_t checkPacketSize(const std::size_t packetSize) {
+	if (!packetSize) {
+		throw std::invalid_argument("The packet size must be positive");
+	}
+	return packetSize;
+}
+
+// returns the count of the packets of a batch
+inline std::size_t getPacketsBatchSize(const ThreadPool& pool, const std::size_t packetsCount, const std::size_t batchSize) {
+	if (batchSize) {
+		return batchSize;
+	}
+	const std::size_t batchesCount = 4 * pool.getThreadsCount();
+	return std::max<std::size_t>(1, (packetsCount + batchesCount - 1) / batchesCount);
+}
+
+template <class Result, class ByteOrder, class BitOrder, class Parse>
+std::vector<Result> parsePackets(ThreadPool& pool, const BinaryReader<uint8_t, ByteOrder, BitOrder>& prototype,
+	const uint8_t* data, const std::size_t sizeInBytes, const std::size_t packetSize, Parse parse, std::size_t batchSize) {
+	static_assert(!std::is_same<Result, bool>::value, "The results of the packets can not be written to std::vector<bool> simultaneously");
+	const std::size_t packetsCount = sizeInBytes / checkPacketSize(packetSize);
+	std::vector<Result> results(packetsCount);
+	batchSize = getPacketsBatchSize(pool, packetsCount, batchSize);
+	// declared after the results, so its destructor waits for the batches before the results are destroyed
+	PacketBatches batches;
+	for (std::size_t first = 0; first < packetsCount; first += batchSize) {
+		const std::size_t last = std::min(packetsCount, first + batchSize);
+		batches.run(pool, [&prototype, &results, &parse, data, packetSize, first, last]() {
+			auto reader = prototype;
+			for (std::size_t idx = first; idx < last; ++idx) {
+				reader.setData(data + idx * packetSize, packetSize);
+				results[idx] = parse(reader, idx);
+			}
+		});
+	}
+	batches.wait();
+	return results;
+}
+
+template <class Result, class ByteOrder, class BitOrder, class Parse>
+std::vector<Result> parsePackets(ThreadPool& pool, const BinaryReader<uint8_t, ByteOrder, BitOrder>& prototype,
+	const VirtualPointer<uint8_t>& data, const std::size_t sizeInBytes, const std::size_t packetSize, Parse parse, std::size_t batchSize) {
+	static_assert(!std::is_same<Result, bool>::value, "The results of the packets can not be written to std::vector<bool> simultaneously");
+	const std::size_t packetsCount = sizeInBytes / checkPacketSize(packetSize);
+	std::vector<Result> results(packetsCount);
+	batchSize = getPacketsBatchSize(pool, packetsCount, batchSize);
+	// the beginnings of the batches are found by one walk over the chunks,
+	// the copies of the pointer only read the shared chunk table
+	VirtualPointer<uint8_t> batch = data;
+	PacketBatches batches;
+	for (std::size_t first = 0; first < packetsCount; first += batchSize) {
+		const std::size_t last = std::min(packetsCount, first + batchSize);
+		batches.run(pool, [&prototype, &results, &parse, batch, packetSize, first, last]() {
+			auto reader = prototype;
+			VirtualPointer<uint8_t> packet = batch;
+			for (std::size_t idx = first; idx < last; ++idx) {
+				reader.setData(packet, packetSize);
+				results[idx] = parse(reader, idx);
+				packet += packetSize;
+			}
+		});
+		if (last < packetsCount) {
+			batch += batchSize * packetSize;
+		}
+	}
+	batches.wait();
+	return results;
+}
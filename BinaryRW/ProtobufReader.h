@@ -0,0 +1,48 @@
+#pragma once
+
+#include "VirtualPointer.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// the wire types of the protobuf fields
+enum class WireType : uint8_t {
+	VARINT = 0,
+	FIXED64 = 1,
+	LENGTH_DELIMITED = 2,
+	START_GROUP = 3,
+	END_GROUP = 4,
+	FIXED32 = 5
+};
+
+struct ProtobufField final {
+	uint32_t number;
+	WireType type;
+	// the value of the varint and fixed fields or the size of the length-delimited field in bytes
+	uint64_t value;
+	// the data of the length-delimited field without copying, the pointer to the memory of the message
+	VirtualPointer<uint8_t> data;
+};
+
+// Iterates over the fields of the protobuf wire format of a message that can be fragmented across chunks.
+// The fields are not interpreted: the nested messages, strings and packed repeated fields are returned
+// as the data of length-delimited fields, the groups as their start and end fields without values.
+// The memory of the message must be valid while the reader or the data of its fields is used.
+class ProtobufReader final {
+public:
+	ProtobufReader(const VirtualPointer<uint8_t>& message, std::size_t sizeInBytes);
+
+	// Reads the next field. Returns false at the end of the message or if the message is broken.
+	bool next(ProtobufField& field);
+	// returns true if the reading stopped at a broken field
+	bool hasError() const;
+
+private:
+	VirtualPointer<uint8_t> m_data;
+	std::size_t m_remainDataSize;
+	bool m_error = false;
+
+	bool readVarint(uint64_t& value);
+	bool readFixed(std::size_t size, uint64_t& value);
+	bool fail();
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 
 using reverse_bytes_t = bool;
 using reverse_bits_t = bool;
@@ -9,6 +10,25 @@ constexpr size_t BITS_IN_BYTE = 8;
 constexpr reverse_bytes_t REVERSE_BYTES = true;
 constexpr reverse_bits_t REVERSE_BITS = true;
 
+// Orders of the bytes and of the bits in a byte for BinaryReader.
+// RuntimeOrder takes the order from the constructor or the setter,
+// the static orders are known at compile time and ignore the runtime value.
+struct RuntimeOrder final
+{
+	static constexpr bool get(const bool runtimeValue) { return runtimeValue; }
+};
+
+template <bool REVERSE>
+struct StaticOrder final
+{
+	static constexpr bool get(bool) { return REVERSE; }
+};
+
+using ReversedBytes = StaticOrder<REVERSE_BYTES>;
+using DirectBytes = StaticOrder<!REVERSE_BYTES>;
+using ReversedBits = StaticOrder<REVERSE_BITS>;
+using DirectBits = StaticOrder<!REVERSE_BITS>;
+
 template<typename T>
 constexpr T multiplyBy8(T value)
 {
@@ -21,7 +41,52 @@ constexpr T divideBy8(T value)
 	return value >> 3;
 }
 
-uint8_t reverseBitsInByte(uint8_t byte);
-std::size_t reverseBytes(std::size_t val);
-std::size_t reverseBits(std::size_t value);
-std::size_t reverseAll(std::size_t value);
\ No newline at end of file
+std::size_t reverseAll(std::size_t value);
+
+// the functions below are used on the hot paths of reading, so they are defined inline
+
+#if _WIN32
+
+#if defined(_M_X64) || defined(__amd64__)
+inline std::size_t reverseBytes(const std::size_t val) {
+	return static_cast<std::size_t>(_byteswap_uint64(val));
+}
+#else
+inline std::size_t reverseBytes(const std::size_t val) {
+	return static_cast<std::size_t>(_byteswap_ulong(val));
+}
+#endif
+
+#else
+#if defined(_M_X64) || defined(__amd64__)
+inline std::size_t reverseBytes(const std::size_t val) {
+	return static_cast<std::size_t>(__builtin_bswap64(val));
+}
+#else
+inline std::size_t reverseBytes(const std::size_t val) {
+	return static_cast<std::size_t>(__builtin_bswap32(val));
+}
+#endif
+
+#endif
+
+
+#if defined(_M_X64) || defined(__amd64__)
+inline std::size_t reverseBits(std::size_t value) {
+	value = (value & 0xF0F0F0F0F0F0F0F0) >> 4 | (value & 0x0F0F0F0F0F0F0F0F) << 4;
+	value = (value & 0xCCCCCCCCCCCCCCCC) >> 2 | (value & 0x3333333333333333) << 2;
+	return (value & 0xAAAAAAAAAAAAAAAA) >> 1 | (value & 0x5555555555555555) << 1;
+}
+#else
+inline std::size_t reverseBits(std::size_t value) {
+	value = (value & 0xF0F0F0F0) >> 4 | (value & 0x0F0F0F0F) << 4;
+	value = (value & 0xCCCCCCCC) >> 2 | (value & 0x33333333) << 2;
+	return (value & 0xAAAAAAAA) >> 1 | (value & 0x55555555) << 1;
+}
+#endif
+
+inline uint8_t reverseBitsInByte(uint8_t byte) {
+	byte = static_cast<uint8_t>((byte & 0xF0) >> 4) | static_cast<uint8_t>((byte & 0x0F) << 4);
+	byte = static_cast<uint8_t>((byte & 0xCC) >> 2) | static_cast<uint8_t>((byte & 0x33) << 2);
+	return static_cast<uint8_t>((byte & 0xAA) >> 1) | static_cast<uint8_t>((byte & 0x55) << 1);
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "BinaryReader.h"
+#include "BitUnpacking.h"
+#include "Varint.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+// Decodes the RLE/bit-packing hybrid encoding of Parquet (the definition and repetition levels, the dictionary indices).
+// The data is a sequence of runs, every run begins with a varint header:
+// (count << 1) | 1 is followed by count groups of eight values bit-packed from the lowest bits of the bytes,
+// count << 1 is followed by the value repeated count times in ceil(bitWidth / 8) little-endian bytes.
+// The repeated values are written by runs, the packed groups are unpacked by readPackedArray() of the reader,
+// so the whole groups are unpacked right from the data when the reader reads the bytes in the order of the memory.
+// The decoder reads the runs from the current position of the reader, the prefixes of the encoded data
+// (the length of the levels or the bit width of the indices) are read by the caller.
+template <class T, class ByteOrder, class BitOrder>
+class RleBitPackedDecoder final {
+public:
+	using Reader = BinaryReader<T, ByteOrder, BitOrder>;
+
+	static constexpr std::size_t GROUP_SIZE = 8;
+
+	// std::invalid_argument is thrown if bitWidth is greater than MAX_PACKED_WIDTH
+	RleBitPackedDecoder(Reader& reader, std::size_t bitWidth);
+
+	// Decodes the next count values.
+	// Returns false if the data is over or a run is broken, the values decoded before are written.
+	bool decode(uint32_t* values, std::size_t count);
+
+	std::size_t getBitWidth() const;
+
+private:
+	Reader& m_reader;
+	std::size_t m_bitWidth;
+	// the values of the current runs that are not decoded yet
+	std::size_t m_repeatedCount = 0;
+	uint32_t m_repeatedValue = 0;
+	std::size_t m_packedCount = 0;
+	// the group unpacked for a request ending inside it, its last m_groupRemain values are not returned yet
+	uint32_t m_group[GROUP_SIZE];
+	std::size_t m_groupRemain = 0;
+
+	bool readPacked(std::size_t count, uint32_t* values);
+	bool readRunHeader();
+};
+
+template <class T, class ByteOrder, class BitOrder>
+constexpr std::size_t RleBitPackedDecoder<T, ByteOrder, BitOrder>::GROUP_SIZE;
+
+template <class T, class ByteOrder, class BitOrder>
+RleBitPackedDecoder<T, ByteOrder, BitOrder>::RleBitPackedDecoder(Reader& reader, const std::size_t bitWidth) :
+	m_reader(reader),
+	m_bitWidth(bitWidth)
+{
+	if (bitWidth > MAX_PACKED_WIDTH) {
+		throw std::invalid_argument("The bit width must not be greater than 32");
+	}
+}
+
+template <class T, class ByteOrder, class BitOrder>
+bool RleBitPackedDecoder<T, ByteOrder, BitOrder>::decode(uint32_t* values, std::size_t count) {
+	while (count) {
+		std::size_t decoded;
+		if (m_groupRemain) {
+			decoded = std::min(count, m_groupRemain);
+			std::copy_n(m_group + GROUP_SIZE - m_groupRemain, decoded, values);
+			m_groupRemain -= decoded;
+		}
+		else if (m_repeatedCount) {
+			decoded = std::min(count, m_repeatedCount);
+			std::fill_n(values, decoded, m_repeatedValue);
+			m_repeatedCount -= decoded;
+		}
+		else if (m_packedCount) {
+			// the whole groups keep the position at the beginning of a byte
+			decoded = std::min(count, m_packedCount) & ~(GROUP_SIZE - 1);
+			if (decoded) {
+				if (!readPacked(decoded, values)) {
+					return false;
+				}
+			}
+			else {
+				if (!readPacked(GROUP_SIZE, m_group)) {
+					return false;
+				}
+				m_groupRemain = GROUP_SIZE;
+			}
+			m_packedCount -= decoded ? decoded : GROUP_SIZE;
+		}
+		else {
+			if (!readRunHeader()) {
+				return false;
+			}
+			decoded = 0;
+		}
+		values += decoded;
+		count -= decoded;
+	}
+	return true;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline std::size_t RleBitPackedDecoder<T, ByteOrder, BitOrder>::getBitWidth() const {
+	return m_bitWidth;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+bool RleBitPackedDecoder<T, ByteOrder, BitOrder>::readPacked(const std::size_t count, uint32_t* values) {
+	// the values of zero width take no bits
+	if (!m_bitWidth) {
+		std::fill_n(values, count, 0);
+		return true;
+	}
+	return m_reader.readPackedArray(m_bitWidth, count, values, BitPacking::LSB_FIRST);
+}
+
+template <class T, class ByteOrder, class BitOrder>
+bool RleBitPackedDecoder<T, ByteOrder, BitOrder>::readRunHeader() {
+	// the bytes of the varint are read up to its last one and decoded by decodeVarint,
+	// so the header longer than MAX_VARINT_SIZE or not fitting 64 bits is broken
+	uint8_t varint[MAX_VARINT_SIZE];
+	std::size_t varintSize = 0;
+	uint8_t byte = 0x80;
+	while (varintSize < MAX_VARINT_SIZE && (byte & 0x80)) {
+		if (!m_reader.readBits(BITS_IN_BYTE, byte)) {
+			return false;
+		}
+		varint[varintSize++] = byte;
+	}
+	uint64_t header;
+	if (decodeVarint(varint, varintSize, header) != varintSize) {
+		return false;
+	}
+	const uint64_t count = header >> 1;
+	// the runs of no values are not written by the encoders, so they are broken
+	if (!count || count > SIZE_MAX / GROUP_SIZE) {
+		return false;
+	}
+	if (header & 1) {
+		m_packedCount = static_cast<std::size_t>(count) * GROUP_SIZE;
+		return true;
+	}
+	uint32_t value = 0;
+	for (std::size_t i = 0; i < divideBy8(m_bitWidth + 7); ++i) {
+		if (!m_reader.readBits(BITS_IN_BYTE, byte)) {
+			return false;
+		}
+		value |= static_cast<uint32_t>(byte) << multiplyBy8(i);
+	}
+	if (m_bitWidth < MAX_PACKED_WIDTH && value >> m_bitWidth) {
+		return false;
+	}
+	m_repeatedCount = static_cast<std::size_t>(count);
+	m_repeatedValue = value;
+	return true;
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "BinaryReader.h"
+#include "ByteSource.h"
+#include "ThreadPool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Reads the bits of an unbounded stream pulled from a ByteSource by blocks of blockSize bytes.
+// Two buffers are used: the next block is read by the prefetching thread of the reader while the current one is parsed,
+// the thread lives as long as the reader, so no thread is started per block,
+// the unread bits of the current block are carried to the beginning of the next one, so the memory is constant.
+// The bytes are read in the order of the stream, the order of the bits is chosen as in BinaryReader.
+// The first block is requested by the first read, so a reader that is not read never calls the source.
+// The exceptions of the source are rethrown by the method that needs the next block.
+template <class BitOrder = RuntimeOrder>
+class StreamBinaryReader final {
+public:
+	using Reader = BinaryReader<uint8_t, ReversedBytes, BitOrder>;
+
+	static constexpr std::size_t DEFAULT_BLOCK_SIZE = 1 << 16;
+
+	// std::invalid_argument is thrown if blockSize is zero
+	explicit StreamBinaryReader(ByteSource& source, std::size_t blockSize = DEFAULT_BLOCK_SIZE, reverse_bits_t reverseBits = !REVERSE_BITS);
+	StreamBinaryReader(const StreamBinaryReader& other) = delete;
+	StreamBinaryReader& operator=(const StreamBinaryReader& other) = delete;
+	// Waits for the read of the next block requested by the last pull of a block: the read can not be cancelled,
+	// so the destructor blocks while the source blocks in ByteSource::read (a socket or a pipe waits for the peer).
+	~StreamBinaryReader() noexcept = default;
+
+	// Return false and do not move the position if the stream is over.
+	bool readBits(std::size_t count, std::size_t& value);
+	template <class V>
+	bool readBits(std::size_t count, V& value);
+	bool lookBits(std::size_t count, std::size_t& value);
+	// Returns false if the stream is over, the position is left at the end of the stream then.
+	bool skipBits(uint64_t count);
+
+	// Pulls the blocks till the reader keeps count bits (not more than the machine word).
+	// Returns false if the stream is over.
+	bool ensureBits(std::size_t count);
+	// The reader of the buffered bits for the methods not repeated here (readUE(), VlcTable and so on),
+	// it can read getBufferedBitsCount() bits. The reader must not be given other data.
+	Reader& getReader();
+	std::size_t getBufferedBitsCount() const;
+
+	uint64_t getReadBitsCount() const;
+
+private:
+	// the unread bytes carried to the next buffer are less than a machine word when ensureBits() pulls a block
+	static constexpr std::size_t CARRY_SIZE = sizeof(std::size_t);
+
+	ByteSource& m_source;
+	std::size_t m_blockSize;
+	// the buffer of the reader and the buffer of the next block, the blocks are placed after CARRY_SIZE bytes
+	std::vector<uint8_t> m_front;
+	std::vector<uint8_t> m_back;
+	// the size of the block read into m_back, it is set by the prefetching thread
+	std::size_t m_nextBlockSize = 0;
+	// the next block is being read or is read and not pulled yet
+	bool m_nextBlockRequested = false;
+	// the one thread reading the blocks, declared after the buffers to be destroyed before them
+	ThreadPool m_prefetcher{ 1 };
+	Reader m_reader;
+	const uint8_t* m_data;
+	std::size_t m_dataSize = 0;
+	// the count of the bits of the stream preceding the data of the reader
+	uint64_t m_dataOffset = 0;
+	bool m_sourceEnded = false;
+
+	void readNextBlock();
+	// moves the unread bytes and the next block to the reader, returns false if the stream is over
+	bool pull();
+};
+
+template <class BitOrder>
+constexpr std::size_t StreamBinaryReader<BitOrder>::DEFAULT_BLOCK_SIZE;
+
+template <class BitOrder>
+constexpr std::size_t StreamBinaryReader<BitOrder>::CARRY_SIZE;
+
+template <class BitOrder>
+StreamBinaryReader<BitOrder>::StreamBinaryReader(ByteSource& source, const std::size_t blockSize, const reverse_bits_t reverseBits) :
+	m_source(source),
+	m_blockSize(blockSize),
+	m_reader(REVERSE_BYTES, reverseBits)
+{
+	if (!blockSize) {
+		throw std::invalid_argument("The block size must be positive");
+	}
+	m_front.resize(CARRY_SIZE + blockSize);
+	m_back.resize(CARRY_SIZE + blockSize);
+	m_data = m_front.data() + CARRY_SIZE;
+}
+
+template <class BitOrder>
+inline bool StreamBinaryReader<BitOrder>::readBits(const std::size_t count, std::size_t& value) {
+	return ensureBits(count) && m_reader.readBits(count, value);
+}
+
+template <class BitOrder>
+template <class V>
+inline bool StreamBinaryReader<BitOrder>::readBits(const std::size_t count, V& value) {
+	static_assert(std::is_integral<V>::value, "ReadBits allows only integral types");
+	return ensureBits(count) && m_reader.readBits(count, value);
+}
+
+template <class BitOrder>
+inline bool StreamBinaryReader<BitOrder>::lookBits(const std::size_t count, std::size_t& value) {
+	return ensureBits(count) && m_reader.lookBits(count, value);
+}
+
+template <class BitOrder>
+bool StreamBinaryReader<BitOrder>::skipBits(uint64_t count) {
+	while (count > getBufferedBitsCount()) {
+		const std::size_t bufferedBits = getBufferedBitsCount();
+		m_reader.skipBits(bufferedBits);
+		count -= bufferedBits;
+		if (!pull()) {
+			return false;
+		}
+	}
+	return m_reader.skipBits(static_cast<std::size_t>(count));
+}
+
+template <class BitOrder>
+inline bool StreamBinaryReader<BitOrder>::ensureBits(const std::size_t count) {
+	if (count > multiplyBy8(sizeof(std::size_t))) {
+		return false;
+	}
+	while (getBufferedBitsCount() < count) {
+		if (!pull()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <class BitOrder>
+inline typename StreamBinaryReader<BitOrder>::Reader& StreamBinaryReader<BitOrder>::getReader() {
+	return m_reader;
+}
+
+template <class BitOrder>
+inline std::size_t StreamBinaryReader<BitOrder>::getBufferedBitsCount() const {
+	return multiplyBy8(m_dataSize) - m_reader.getReadBitsCount();
+}
+
+template <class BitOrder>
+inline uint64_t StreamBinaryReader<BitOrder>::getReadBitsCount() const {
+	return m_dataOffset + m_reader.getReadBitsCount();
+}
+
+template <class BitOrder>
+void StreamBinaryReader<BitOrder>::readNextBlock() {
+	uint8_t* block = m_back.data() + CARRY_SIZE;
+	m_nextBlockRequested = true;
+	m_prefetcher.run([this, block]() {
+		m_nextBlockSize = m_source.read(block, m_blockSize);
+	});
+}
+
+template <class BitOrder>
+bool StreamBinaryReader<BitOrder>::pull() {
+	if (m_sourceEnded) {
+		return false;
+	}
+	if (!m_nextBlockRequested) {
+		// the first block
+		readNextBlock();
+	}
+	m_nextBlockRequested = false;
+	try {
+		m_prefetcher.wait();
+	}
+	catch (...) {
+		// no block is requested after the exception of the source
+		m_sourceEnded = true;
+		throw;
+	}
+	const std::size_t blockSize = m_nextBlockSize;
+	if (!blockSize) {
+		m_sourceEnded = true;
+		return false;
+	}
+	const std::size_t readBits = m_reader.getReadBitsCount();
+	const std::size_t firstUnreadByte = static_cast<std::size_t>(divideBy8(readBits));
+	const std::size_t carriedSize = m_dataSize - firstUnreadByte;
+	assert(carriedSize <= CARRY_SIZE);
+	uint8_t* data = m_back.data() + CARRY_SIZE - carriedSize;
+	std::memcpy(data, m_data + firstUnreadByte, carriedSize);
+	m_dataOffset += multiplyBy8(static_cast<uint64_t>(firstUnreadByte));
+	m_data = data;
+	m_dataSize = carriedSize + blockSize;
+	m_reader.setData(m_data, m_dataSize);
+	m_reader.skipBits(readBits & LITTLE_BITS[3]);
+	// the buffers keep their memory, so the reader stays on the data
+	std::swap(m_front, m_back);
+	readNextBlock();
+	return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads running the queued tasks.
+// The first exception thrown by a task is rethrown by wait(), the tasks queued after it are still run.
+class ThreadPool final {
+public:
+	// zero means the count of the hardware threads
+	explicit ThreadPool(std::size_t threadsCount = 0);
+	ThreadPool(const ThreadPool& other) = delete;
+	ThreadPool& operator=(const ThreadPool& other) = delete;
+	// waits for the queued tasks
+	~ThreadPool() noexcept;
+
+	std::size_t getThreadsCount() const;
+
+	void run(std::function<void()> task);
+	// blocks until all the queued tasks are done
+	void wait();
+
+private:
+	std::vector<std::thread> m_threads;
+	std::queue<std::function<void()>> m_tasks;
+	std::mutex m_mutex;
+	std::condition_variable m_taskQueued;
+	std::condition_variable m_tasksDone;
+	// the count of the queued and running tasks
+	std::size_t m_pendingTasks = 0;
+	std::exception_ptr m_exception;
+	bool m_stop = false;
+
+	void work();
+};
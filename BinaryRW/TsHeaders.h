@@ -0,0 +1,28 @@
+#pragma once
+
+#include "VirtualPointer.h"
+
+#include <cstddef>
+#include <cstdint>
+
+constexpr std::size_t TS_PACKET_SIZE = 188;
+constexpr std::size_t TS_HEADER_SIZE = 4;
+constexpr uint8_t TS_SYNC_BYTE = 0x47;
+
+// The fields of the headers of MPEG-TS packets as structure of arrays,
+// every array must have room for the fields of all the parsed packets.
+struct TsHeaderArrays final {
+	uint8_t* syncByte;
+	uint8_t* payloadUnitStart;
+	uint16_t* pid;
+	uint8_t* continuityCounter;
+};
+
+// Batch extraction of the header fields of count packets following one another every TS_PACKET_SIZE bytes.
+// Eight headers are parsed at once by SSE2 when it is available.
+// The memory must contain the headers of all the packets.
+void parseTsHeaders(const uint8_t* packets, std::size_t count, const TsHeaderArrays& headers);
+
+// The same for the packets of a virtual pointer, the runs of the headers inside one chunk are parsed as contiguous memory.
+// Returns the count of the parsed packets, it is less than count if the data is over.
+std::size_t parseTsHeaders(const VirtualPointer<uint8_t>& packets, std::size_t count, const TsHeaderArrays& headers);
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "VirtualPointer.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// LEB128 (protobuf varint) decoding of unsigned 64-bit values: 7 bits per byte starting from the lowest ones,
+// the highest bit of every byte except the last one is set.
+constexpr std::size_t MAX_VARINT_SIZE = 10;
+
+// Decodes the varint at the beginning of the data of size bytes.
+// Returns the size of the varint or zero if the data is over or the varint is longer than MAX_VARINT_SIZE
+// or does not fit 64 bits. On 64-bit platforms a varint of contiguous MAX_VARINT_SIZE bytes is decoded
+// without a loop over its bytes: its 7-bit groups are joined by shifts and masks, or by PEXT
+// when the target has BMI2 (-mbmi2, /arch:AVX2). The projects of the solution do not set it,
+// so they build the shifts and masks.
+std::size_t decodeVarint(const uint8_t* data, std::size_t size, uint64_t& value);
+
+// Decodes the varint at the position of the pointer and moves the pointer after it.
+// The varint inside the current chunk is decoded from the memory of the chunk, otherwise its bytes are copied.
+// Returns false and does not move the pointer if the varint is broken or the data is over.
+bool readVarint(VirtualPointer<uint8_t>& data, uint64_t& value);
+
+// the zigzag encoding of the signed values of the sint32 and sint64 fields
+inline int64_t decodeZigzag(const uint64_t value) {
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "BinaryReader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A code of the variable length code table, the code is read starting from its most significant bit.
+struct VlcCode final {
+	uint32_t code;
+	uint8_t length;
+	uint16_t symbol;
+};
+
+// Table-driven decoder of variable length codes (Huffman codes of MPEG tables, DEFLATE and so on).
+// The root table is indexed by the next rootBits bits of the data, the codes longer than rootBits
+// are decoded by one more lookup in the subtable of their first rootBits bits.
+// The multi-symbol table also decodes the second code by the same root lookup
+// when both codes are not longer than rootBits together.
+// The codes must be prefix-free and not longer than MAX_CODE_LENGTH bits, otherwise std::invalid_argument is thrown.
+// The table is immutable after construction and can be used by several readers simultaneously.
+class VlcTable final {
+public:
+	static constexpr std::size_t MAX_CODE_LENGTH = 24;
+	static constexpr std::size_t MAX_ROOT_BITS = 16;
+
+	VlcTable(const VlcCode* codes, std::size_t count, std::size_t rootBits, bool multiSymbol = false);
+	// builds the canonical Huffman codes (as DEFLATE does) from the code lengths of the symbols 0, 1, ...,
+	// zero length means that the symbol is not used
+	static VlcTable fromCodeLengths(const uint8_t* lengths, std::size_t symbolsCount, std::size_t rootBits, bool multiSymbol = false);
+
+	// Decodes the next code and skips it.
+	// Returns false and does not move the position if the data does not begin with a code of the table.
+	template <class T, class ByteOrder, class BitOrder>
+	bool decode(BinaryReader<T, ByteOrder, BitOrder>& reader, uint16_t& symbol) const;
+	// Decodes one or two next codes (two only by the multi-symbol table), writes their symbols to symbols
+	// and returns the count of the decoded symbols or zero similarly to decode().
+	template <class T, class ByteOrder, class BitOrder>
+	std::size_t decodeSymbols(BinaryReader<T, ByteOrder, BitOrder>& reader, uint16_t* symbols) const;
+
+	std::size_t getRootBits() const;
+	std::size_t getMaxCodeLength() const;
+
+private:
+	struct Entry final {
+		// the first symbol or the index of the first entry of the subtable
+		uint32_t value;
+		uint16_t secondSymbol;
+		// the length of the code of the first symbol, zero for a link to the subtable and for an unused entry
+		uint8_t firstLength;
+		// the length of the codes of both symbols or the bits of the index of the subtable
+		uint8_t length;
+	};
+
+	std::vector<Entry> m_entries;
+	std::size_t m_rootBits;
+	std::size_t m_maxCodeLength = 0;
+
+	// finds the entry of the code at the current position, cachedBits are the bits available after refill()
+	template <class T, class ByteOrder, class BitOrder>
+	const Entry* find(const BinaryReader<T, ByteOrder, BitOrder>& reader, std::size_t cachedBits) const;
+	// looks count bits after offset bits, the bits beyond cachedBits are zeros
+	template <class T, class ByteOrder, class BitOrder>
+	static std::size_t lookIndex(const BinaryReader<T, ByteOrder, BitOrder>& reader, std::size_t cachedBits, std::size_t offset, std::size_t count);
+	void pairSymbols();
+};
+
+template <class T, class ByteOrder, class BitOrder>
+bool VlcTable::decode(BinaryReader<T, ByteOrder, BitOrder>& reader, uint16_t& symbol) const {
+	reader.refill();
+	const std::size_t cachedBits = reader.getCachedBitsCount();
+	const Entry* entry = find(reader, cachedBits);
+	if (nullptr == entry) {
+		return false;
+	}
+	symbol = static_cast<uint16_t>(entry->value);
+	reader.skipBitsUnchecked(entry->firstLength);
+	return true;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+std::size_t VlcTable::decodeSymbols(BinaryReader<T, ByteOrder, BitOrder>& reader, uint16_t* symbols) const {
+	reader.refill();
+	const std::size_t cachedBits = reader.getCachedBitsCount();
+	const Entry* entry = find(reader, cachedBits);
+	if (nullptr == entry) {
+		return 0;
+	}
+	symbols[0] = static_cast<uint16_t>(entry->value);
+	if (entry->length > entry->firstLength && entry->length <= cachedBits) {
+		symbols[1] = entry->secondSymbol;
+		reader.skipBitsUnchecked(entry->length);
+		return 2;
+	}
+	reader.skipBitsUnchecked(entry->firstLength);
+	return 1;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+const VlcTable::Entry* VlcTable::find(const BinaryReader<T, ByteOrder, BitOrder>& reader, const std::size_t cachedBits) const {
+	const Entry* entry = &m_entries[lookIndex(reader, cachedBits, 0, m_rootBits)];
+	if (!entry->firstLength) {
+		if (!entry->length) {
+			return nullptr;
+		}
+		entry = &m_entries[entry->value + lookIndex(reader, cachedBits, m_rootBits, entry->length)];
+	}
+	if (!entry->firstLength || entry->firstLength > cachedBits) {
+		return nullptr;
+	}
+	return entry;
+}
+
+template <class T, class ByteOrder, class BitOrder>
+inline std::size_t VlcTable::lookIndex(const BinaryReader<T, ByteOrder, BitOrder>& reader, const std::size_t cachedBits, const std::size_t offset, const std::size_t count) {
+	if (offset + count <= cachedBits) {
+		return reader.lookBitsUnchecked(offset + count) & LITTLE_BITS[count];
+	}
+	// the tail of the data
+	if (offset >= cachedBits) {
+		return 0;
+	}
+	return (reader.lookBitsUnchecked(cachedBits) << (offset + count - cachedBits)) & LITTLE_BITS[count];
+}
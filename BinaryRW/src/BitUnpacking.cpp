@@ -0,0 +1,223 @@
+#include "pch.h"
+#include "BitUnpacking.h"
+#include "Reverser.h"
+
+#include <cassert>
+#include <utility>
+
+// The SSE4.1 kernels are compiled on x86 for any target. Unless the target has SSE4.1 (/arch:AVX, -msse4.1),
+// they are chosen at runtime by cpuid: MSVC compiles the intrinsics for any target,
+// GCC and Clang compile the kernels for SSE4.1 by the target attribute.
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define BIT_UNPACKING_SSE41
+#define BIT_UNPACKING_SSE41_TARGET
+#include <smmintrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#define BIT_UNPACKING_SSE41
+#define BIT_UNPACKING_DISPATCH
+#define BIT_UNPACKING_SSE41_TARGET
+#include <intrin.h>
+#include <smmintrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#define BIT_UNPACKING_SSE41
+#define BIT_UNPACKING_DISPATCH
+#define BIT_UNPACKING_SSE41_TARGET __attribute__((target("sse4.1")))
+#include <smmintrin.h>
+#endif
+
+using std::size_t;
+
+namespace {
+
+// loads 8 bytes as a big-endian number, the bytes beyond size are zeros
+inline uint64_t loadBigEndian(const uint8_t* data, const size_t size) {
+	uint64_t value = 0;
+	if (size >= sizeof(uint64_t)) {
+		for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+			value = (value << BITS_IN_BYTE) | data[i];
+		}
+		return value;
+	}
+	for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+		value = (value << BITS_IN_BYTE) | (i < size ? data[i] : 0);
+	}
+	return value;
+}
+
+// loads 8 bytes as a little-endian number, the bytes beyond size are zeros
+inline uint64_t loadLittleEndian(const uint8_t* data, const size_t size) {
+	uint64_t value = 0;
+	const size_t count = size < sizeof(uint64_t) ? size : sizeof(uint64_t);
+	for (size_t i = 0; i < count; ++i) {
+		value |= static_cast<uint64_t>(data[i]) << multiplyBy8(i);
+	}
+	return value;
+}
+
+template <size_t WIDTH, BitPacking PACKING>
+void unpackScalar(const uint8_t* data, const size_t size, const size_t bitOffset, const size_t first, const size_t count, uint32_t* values) {
+	constexpr uint64_t MASK = (static_cast<uint64_t>(1) << WIDTH) - 1;
+	for (size_t idx = first; idx < count; ++idx) {
+		const size_t bit = bitOffset + idx * WIDTH;
+		const size_t byteIdx = divideBy8(bit);
+		const size_t shift = bit & 7;
+		if (BitPacking::MSB_FIRST == PACKING) {
+			values[idx] = static_cast<uint32_t>((loadBigEndian(data + byteIdx, size - byteIdx) << shift) >> (64 - WIDTH));
+		}
+		else {
+			values[idx] = static_cast<uint32_t>((loadLittleEndian(data + byteIdx, size - byteIdx) >> shift) & MASK);
+		}
+	}
+}
+
+#if defined(BIT_UNPACKING_SSE41)
+// The values of WIDTH > 25 bits are unpacked in 64-bit lanes, two values from every 16-byte load:
+// the shuffle gathers eight bytes of every value into its lane, SSE4.1 has no shift by lanes of 64 bits,
+// so the register is shifted by the counts of both lanes and the lanes are blended.
+template <size_t WIDTH, BitPacking PACKING>
+BIT_UNPACKING_SSE41_TARGET size_t unpackWideGroups(const uint8_t* data, const size_t size, const size_t bitOffset, const size_t count, uint32_t* values) {
+	constexpr size_t GROUP_SIZE = 8;
+	constexpr size_t LANES = 2;
+	constexpr size_t LOADS = GROUP_SIZE / LANES;
+	__m128i shuffles[LOADS];
+	__m128i shifts[LOADS][LANES];
+	size_t loadOffsets[LOADS];
+	for (size_t load = 0; load < LOADS; ++load) {
+		loadOffsets[load] = divideBy8(bitOffset + load * LANES * WIDTH);
+		alignas(16) uint8_t shuffle[16];
+		for (size_t lane = 0; lane < LANES; ++lane) {
+			const size_t bit = bitOffset + (load * LANES + lane) * WIDTH - multiplyBy8(loadOffsets[load]);
+			const size_t byteIdx = divideBy8(bit);
+			const size_t shift = bit & 7;
+			for (size_t i = 0; i < 8; ++i) {
+				shuffle[lane * 8 + i] = static_cast<uint8_t>(byteIdx + (BitPacking::MSB_FIRST == PACKING ? 7 - i : i));
+			}
+			shifts[load][lane] = _mm_cvtsi32_si128(static_cast<int>(BitPacking::MSB_FIRST == PACKING ? 64 - WIDTH - shift : shift));
+		}
+		shuffles[load] = _mm_load_si128(reinterpret_cast<const __m128i*>(shuffle));
+	}
+	const __m128i mask = _mm_set1_epi32(static_cast<int>((static_cast<uint64_t>(1) << WIDTH) - 1));
+	const size_t loadsEnd = loadOffsets[LOADS - 1] + 16;
+	size_t idx = 0;
+	for (size_t groupByte = 0; idx + GROUP_SIZE <= count && groupByte + loadsEnd <= size; groupByte += WIDTH, idx += GROUP_SIZE) {
+		__m128i lanes[LOADS];
+		for (size_t load = 0; load < LOADS; ++load) {
+			const __m128i bytes = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + groupByte + loadOffsets[load])), shuffles[load]);
+			lanes[load] = _mm_blend_epi16(_mm_srl_epi64(bytes, shifts[load][0]), _mm_srl_epi64(bytes, shifts[load][1]), 0xF0);
+		}
+		// the values are the low halves of the lanes
+		for (size_t half = 0; half < 2; ++half) {
+			const __m128i packed = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lanes[half * 2]), _mm_castsi128_ps(lanes[half * 2 + 1]), _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(values + idx + half * 4), _mm_and_si128(packed, mask));
+		}
+	}
+	return idx;
+}
+
+// Eight values take WIDTH whole bytes, so every group of eight values has the same layout.
+// Every half of a group is unpacked from one 16-byte load: the shuffle gathers four bytes of every value into its lane
+// (in the big-endian order for MSB_FIRST), the multiplication by a power of two moves the bits of every value
+// to the same position, so one shift extracts four values. The value with its shift must fit the lane,
+// so the wider values are unpacked by unpackWideGroups.
+template <size_t WIDTH, BitPacking PACKING>
+BIT_UNPACKING_SSE41_TARGET size_t unpackGroups(const uint8_t* data, const size_t size, const size_t bitOffset, const size_t count, uint32_t* values) {
+	constexpr size_t GROUP_SIZE = 8;
+	constexpr size_t LANES = 4;
+	if (WIDTH > 25) {
+		return unpackWideGroups<WIDTH, PACKING>(data, size, bitOffset, count, values);
+	}
+	__m128i shuffles[2];
+	__m128i multipliers[2];
+	size_t loadOffsets[2];
+	for (size_t half = 0; half < 2; ++half) {
+		loadOffsets[half] = divideBy8(bitOffset + half * LANES * WIDTH);
+		alignas(16) uint8_t shuffle[16];
+		alignas(16) uint32_t multiplier[LANES];
+		for (size_t lane = 0; lane < LANES; ++lane) {
+			const size_t bit = bitOffset + (half * LANES + lane) * WIDTH - multiplyBy8(loadOffsets[half]);
+			const size_t byteIdx = divideBy8(bit);
+			const size_t shift = bit & 7;
+			for (size_t i = 0; i < 4; ++i) {
+				shuffle[lane * 4 + i] = static_cast<uint8_t>(byteIdx + (BitPacking::MSB_FIRST == PACKING ? 3 - i : i));
+			}
+			multiplier[lane] = static_cast<uint32_t>(1) << (BitPacking::MSB_FIRST == PACKING ? shift : 7 - shift);
+		}
+		shuffles[half] = _mm_load_si128(reinterpret_cast<const __m128i*>(shuffle));
+		multipliers[half] = _mm_load_si128(reinterpret_cast<const __m128i*>(multiplier));
+	}
+	const __m128i mask = _mm_set1_epi32(static_cast<int>((static_cast<uint64_t>(1) << WIDTH) - 1));
+	const size_t loadsEnd = loadOffsets[1] + 16;
+	size_t idx = 0;
+	for (size_t groupByte = 0; idx + GROUP_SIZE <= count && groupByte + loadsEnd <= size; groupByte += WIDTH, idx += GROUP_SIZE) {
+		for (size_t half = 0; half < 2; ++half) {
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + groupByte + loadOffsets[half]));
+			__m128i lanes = _mm_mullo_epi32(_mm_shuffle_epi8(bytes, shuffles[half]), multipliers[half]);
+			if (BitPacking::MSB_FIRST == PACKING) {
+				lanes = _mm_srli_epi32(lanes, static_cast<int>(32 - WIDTH));
+			}
+			else {
+				lanes = _mm_and_si128(_mm_srli_epi32(lanes, 7), mask);
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(values + idx + half * LANES), lanes);
+		}
+	}
+	return idx;
+}
+#endif
+
+bool hasSse41() {
+#if defined(BIT_UNPACKING_DISPATCH) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	return 0 != (info[2] & (1 << 19));
+#elif defined(BIT_UNPACKING_DISPATCH)
+	return __builtin_cpu_supports("sse4.1");
+#elif defined(BIT_UNPACKING_SSE41)
+	return true;
+#else
+	return false;
+#endif
+}
+
+template <size_t WIDTH, BitPacking PACKING, bool VECTOR>
+void unpackWidth(const uint8_t* data, const size_t bitOffset, const size_t count, uint32_t* values) {
+	const size_t size = divideBy8(bitOffset + count * WIDTH + 7);
+	size_t first = 0;
+#if defined(BIT_UNPACKING_SSE41)
+	if (VECTOR) {
+		first = unpackGroups<WIDTH, PACKING>(data, size, bitOffset, count, values);
+	}
+#endif
+	unpackScalar<WIDTH, PACKING>(data, size, bitOffset, first, count, values);
+}
+
+using Kernel = void (*)(const uint8_t* data, size_t bitOffset, size_t count, uint32_t* values);
+
+template <BitPacking PACKING, bool VECTOR, size_t... WIDTHS>
+const Kernel* getKernels(std::index_sequence<WIDTHS...>) {
+	static const Kernel kernels[] = { &unpackWidth<WIDTHS + 1, PACKING, VECTOR>... };
+	return kernels;
+}
+
+template <BitPacking PACKING>
+const Kernel* getKernels() {
+	return hasSse41()
+		? getKernels<PACKING, true>(std::make_index_sequence<MAX_PACKED_WIDTH>())
+		: getKernels<PACKING, false>(std::make_index_sequence<MAX_PACKED_WIDTH>());
+}
+
+}
+
+bool hasVectorUnpacking() {
+	static const bool vector = hasSse41();
+	return vector;
+}
+
+void unpackBits(const uint8_t* data, const size_t bitOffset, const size_t width, const size_t count, uint32_t* values, const BitPacking packing) {
+	assert(width && width <= MAX_PACKED_WIDTH && bitOffset < BITS_IN_BYTE);
+	// the kernels are chosen once by the instructions of the processor
+	static const Kernel* const msbFirstKernels = getKernels<BitPacking::MSB_FIRST>();
+	static const Kernel* const lsbFirstKernels = getKernels<BitPacking::LSB_FIRST>();
+	const Kernel* kernels = BitPacking::MSB_FIRST == packing ? msbFirstKernels : lsbFirstKernels;
+	kernels[width - 1](data, bitOffset, count, values);
+}
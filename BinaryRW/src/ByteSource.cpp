@@ -0,0 +1,61 @@
+#include "pch.h"
+#include "ByteSource.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using std::size_t;
+
+CallbackByteSource::CallbackByteSource(Callback callback) :
+	m_callback(std::move(callback))
+{
+}
+
+size_t CallbackByteSource::read(uint8_t* buffer, const size_t size) {
+	return m_callback(buffer, size);
+}
+
+FileByteSource::FileByteSource(const int fd) :
+	m_fd(fd)
+{
+}
+
+size_t FileByteSource::read(uint8_t* buffer, const size_t size) {
+	// a single call can not read more than INT_MAX bytes on all the platforms
+	const size_t count = std::min<size_t>(size, INT_MAX);
+	for (;;) {
+#ifdef _WIN32
+		const int result = ::_read(m_fd, buffer, static_cast<unsigned int>(count));
+#else
+		const ssize_t result = ::read(m_fd, buffer, count);
+#endif
+		if (result >= 0) {
+			return static_cast<size_t>(result);
+		}
+		if (EINTR != errno) {
+			throw std::system_error(errno, std::generic_category(), "The file descriptor can not be read");
+		}
+	}
+}
+
+StreamByteSource::StreamByteSource(std::istream& stream) :
+	m_stream(stream)
+{
+}
+
+size_t StreamByteSource::read(uint8_t* buffer, const size_t size) {
+	m_stream.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(size));
+	if (m_stream.bad()) {
+		throw std::ios_base::failure("The stream can not be read");
+	}
+	return static_cast<size_t>(m_stream.gcount());
+}
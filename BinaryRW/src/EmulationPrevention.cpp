@@ -0,0 +1,76 @@
+#include "pch.h"
+#include "EmulationPrevention.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EMULATION_PREVENTION_SSE2
+#include <emmintrin.h>
+#endif
+
+using std::size_t;
+
+constexpr uint8_t EMULATION_PREVENTION_BYTE = 0x03;
+
+static bool isEmulationPreventionByte(const uint8_t* nal, const size_t idx) {
+	return EMULATION_PREVENTION_BYTE == nal[idx] && !nal[idx - 1] && !nal[idx - 2];
+}
+
+#if defined(EMULATION_PREVENTION_SSE2)
+size_t findEmulationPreventionByte(const uint8_t* nal, size_t from, const size_t size) {
+	if (from < 2) {
+		from = 2;
+	}
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i three = _mm_set1_epi8(EMULATION_PREVENTION_BYTE);
+	// every lane i checks the bytes i - 2, i - 1 and i of the block
+	for (; from + 16 <= size; from += 16) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(nal + from));
+		const __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(nal + from - 1));
+		const __m128i beforePrevious = _mm_loadu_si128(reinterpret_cast<const __m128i*>(nal + from - 2));
+		const __m128i found = _mm_and_si128(
+			_mm_cmpeq_epi8(bytes, three),
+			_mm_and_si128(_mm_cmpeq_epi8(previous, zero), _mm_cmpeq_epi8(beforePrevious, zero))
+		);
+		const int mask = _mm_movemask_epi8(found);
+		if (mask) {
+			size_t idx = 0;
+			while (!(mask & (1 << idx))) {
+				++idx;
+			}
+			return from + idx;
+		}
+	}
+	for (; from < size; ++from) {
+		if (isEmulationPreventionByte(nal, from)) {
+			return from;
+		}
+	}
+	return size;
+}
+#else
+size_t findEmulationPreventionByte(const uint8_t* nal, size_t from, const size_t size) {
+	if (from < 2) {
+		from = 2;
+	}
+	for (; from < size; ++from) {
+		if (isEmulationPreventionByte(nal, from)) {
+			return from;
+		}
+	}
+	return size;
+}
+#endif
+
+size_t addRbspChunks(VirtualPointer<uint8_t>& rbsp, const uint8_t* nal, const size_t size) {
+	// the chunks are only read through rbsp
+	auto data = const_cast<uint8_t*>(nal);
+	size_t rbspSize = 0;
+	size_t chunkBegin = 0;
+	while (chunkBegin < size) {
+		const size_t chunkEnd = findEmulationPreventionByte(nal, chunkBegin, size);
+		rbsp.addChunk(data + chunkBegin, chunkEnd - chunkBegin);
+		rbspSize += chunkEnd - chunkBegin;
+		// the emulation prevention byte is skipped, the next one can follow it only after two new zero bytes
+		chunkBegin = chunkEnd + 1;
+	}
+	return rbspSize;
+}
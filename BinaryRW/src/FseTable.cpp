@@ -0,0 +1,70 @@
+#include "pch.h"
+#include "FseTable.h"
+
+#include <stdexcept>
+
+using std::size_t;
+
+constexpr size_t FseTable::MIN_TABLE_LOG;
+constexpr size_t FseTable::MAX_TABLE_LOG;
+constexpr size_t FseTable::MAX_SYMBOLS;
+constexpr size_t FseTable::MAX_STATES;
+
+FseTable::FseTable(const int16_t* normalizedCounts, const size_t symbolsCount, const size_t tableLog) :
+	m_tableLog(tableLog)
+{
+	if (tableLog < MIN_TABLE_LOG || tableLog > MAX_TABLE_LOG) {
+		throw std::invalid_argument("The table log must be from 5 to 15");
+	}
+	if (symbolsCount > MAX_SYMBOLS) {
+		throw std::invalid_argument("The table can not contain more than 256 symbols");
+	}
+	const size_t tableSize = static_cast<size_t>(1) << tableLog;
+	size_t countsSum = 0;
+	for (size_t symbol = 0; symbol < symbolsCount; ++symbol) {
+		if (normalizedCounts[symbol] < -1) {
+			throw std::invalid_argument("The normalized count can not be less than -1");
+		}
+		countsSum += normalizedCounts[symbol] == -1 ? 1 : static_cast<size_t>(normalizedCounts[symbol]);
+	}
+	if (countsSum != tableSize) {
+		throw std::invalid_argument("The sum of the normalized counts must be the table size");
+	}
+	m_entries.assign(tableSize, Entry{ 0, 0, 0 });
+	// the symbols of the low probability take the last states, the rest are spread over the table as in zstd
+	size_t nextStates[MAX_SYMBOLS];
+	size_t highThreshold = tableSize - 1;
+	for (size_t symbol = 0; symbol < symbolsCount; ++symbol) {
+		if (normalizedCounts[symbol] == -1) {
+			m_entries[highThreshold--].symbol = static_cast<uint8_t>(symbol);
+			nextStates[symbol] = 1;
+		}
+		else {
+			nextStates[symbol] = static_cast<size_t>(normalizedCounts[symbol]);
+		}
+	}
+	const size_t step = (tableSize >> 1) + (tableSize >> 3) + 3;
+	size_t position = 0;
+	for (size_t symbol = 0; symbol < symbolsCount; ++symbol) {
+		for (int16_t i = 0; i < normalizedCounts[symbol]; ++i) {
+			m_entries[position].symbol = static_cast<uint8_t>(symbol);
+			do {
+				position = (position + step) & (tableSize - 1);
+			} while (position > highThreshold);
+		}
+	}
+	if (position) {
+		throw std::invalid_argument("The normalized counts can not be spread over the table");
+	}
+	// the states of a symbol read the bits that bring the next state to [tableSize, 2 * tableSize)
+	const size_t bitness = multiplyBy8(sizeof(size_t));
+	for (Entry& entry : m_entries) {
+		const size_t nextState = nextStates[entry.symbol]++;
+		entry.bitsCount = static_cast<uint8_t>(tableLog - (bitness - 1 - countLeadingZeros(nextState)));
+		entry.baseState = static_cast<uint16_t>((nextState << entry.bitsCount) - tableSize);
+	}
+}
+
+size_t FseTable::getTableLog() const {
+	return m_tableLog;
+}
@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "ProtobufReader.h"
+#include "Varint.h"
+
+#include <cstring>
+
+using std::size_t;
+
+constexpr size_t WIRE_TYPE_BITS = 3;
+
+ProtobufReader::ProtobufReader(const VirtualPointer<uint8_t>& message, const size_t sizeInBytes) :
+	m_data(message),
+	m_remainDataSize(sizeInBytes)
+{
+}
+
+bool ProtobufReader::next(ProtobufField& field) {
+	if (!m_remainDataSize || m_error) {
+		return false;
+	}
+	uint64_t key;
+	if (!readVarint(key) || !(key >> WIRE_TYPE_BITS) || key >> WIRE_TYPE_BITS > UINT32_MAX) {
+		return fail();
+	}
+	field.number = static_cast<uint32_t>(key >> WIRE_TYPE_BITS);
+	field.type = static_cast<WireType>(key & 0x7);
+	field.value = 0;
+	switch (field.type) {
+	case WireType::VARINT:
+		return readVarint(field.value) || fail();
+	case WireType::FIXED64:
+		return readFixed(sizeof(uint64_t), field.value) || fail();
+	case WireType::FIXED32:
+		return readFixed(sizeof(uint32_t), field.value) || fail();
+	case WireType::LENGTH_DELIMITED:
+		if (!readVarint(field.value) || field.value > m_remainDataSize) {
+			return fail();
+		}
+		field.data = m_data;
+		m_remainDataSize -= static_cast<size_t>(field.value);
+		m_data += static_cast<size_t>(field.value);
+		return true;
+	case WireType::START_GROUP:
+	case WireType::END_GROUP:
+		return true;
+	default:
+		return fail();
+	}
+}
+
+bool ProtobufReader::hasError() const {
+	return m_error;
+}
+
+bool ProtobufReader::readVarint(uint64_t& value) {
+	const size_t bytesRemaining = m_data.bytesRemaining();
+	VirtualPointer<uint8_t> varint = m_data;
+	if (!::readVarint(varint, value)) {
+		return false;
+	}
+	const size_t size = bytesRemaining - varint.bytesRemaining();
+	if (size > m_remainDataSize) {
+		return false;
+	}
+	m_data = varint;
+	m_remainDataSize -= size;
+	return true;
+}
+
+bool ProtobufReader::readFixed(const size_t size, uint64_t& value) {
+	if (size > m_remainDataSize) {
+		return false;
+	}
+	// the fixed fields are little-endian as the memory of the supported hosts
+	value = 0;
+	memcpy(&value, m_data, size);
+	m_remainDataSize -= size;
+	m_data += size;
+	return true;
+}
+
+bool ProtobufReader::fail() {
+	m_error = true;
+	return false;
+}
@@ -0,0 +1,87 @@
+#include "pch.h"
+#include "ThreadPool.h"
+
+#include <utility>
+
+using std::size_t;
+
+ThreadPool::ThreadPool(size_t threadsCount) {
+	if (!threadsCount) {
+		threadsCount = std::thread::hardware_concurrency();
+	}
+	if (!threadsCount) {
+		threadsCount = 1;
+	}
+	m_threads.reserve(threadsCount);
+	for (size_t i = 0; i < threadsCount; ++i) {
+		m_threads.emplace_back(&ThreadPool::work, this);
+	}
+}
+
+ThreadPool::~ThreadPool() noexcept {
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_tasksDone.wait(lock, [this]() { return !m_pendingTasks; });
+		m_stop = true;
+	}
+	m_taskQueued.notify_all();
+	for (auto& thread : m_threads) {
+		thread.join();
+	}
+}
+
+size_t ThreadPool::getThreadsCount() const {
+	return m_threads.size();
+}
+
+void ThreadPool::run(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push(std::move(task));
+		++m_pendingTasks;
+	}
+	m_taskQueued.notify_one();
+}
+
+void ThreadPool::wait() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_tasksDone.wait(lock, [this]() { return !m_pendingTasks; });
+	if (m_exception) {
+		std::exception_ptr exception;
+		std::swap(exception, m_exception);
+		std::rethrow_exception(exception);
+	}
+}
+
+void ThreadPool::work() {
+	for (;;) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_taskQueued.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+			if (m_tasks.empty()) {
+				return;
+			}
+			task = std::move(m_tasks.front());
+			m_tasks.pop();
+		}
+		std::exception_ptr exception;
+		try {
+			task();
+		}
+		catch (...) {
+			exception = std::current_exception();
+		}
+		bool done;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (exception && !m_exception) {
+				m_exception = exception;
+			}
+			done = !--m_pendingTasks;
+		}
+		if (done) {
+			m_tasksDone.notify_all();
+		}
+	}
+}
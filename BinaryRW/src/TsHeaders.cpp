@@ -0,0 +1,110 @@
+#include "pch.h"
+#include "TsHeaders.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TS_HEADERS_SSE2
+#include <emmintrin.h>
+#endif
+
+using std::size_t;
+
+// the header bytes b0 b1 b2 b3 as the little-endian word b0 | b1 << 8 | b2 << 16 | b3 << 24
+static uint32_t loadHeader(const uint8_t* packet) {
+	return static_cast<uint32_t>(packet[0]) | static_cast<uint32_t>(packet[1]) << 8 |
+		static_cast<uint32_t>(packet[2]) << 16 | static_cast<uint32_t>(packet[3]) << 24;
+}
+
+static void parseTsHeader(const uint8_t* packet, const TsHeaderArrays& headers, const size_t idx) {
+	const uint32_t header = loadHeader(packet);
+	headers.syncByte[idx] = static_cast<uint8_t>(header);
+	headers.payloadUnitStart[idx] = static_cast<uint8_t>((header >> 14) & 0x1);
+	headers.pid[idx] = static_cast<uint16_t>((header & 0x1F00) | ((header >> 16) & 0xFF));
+	headers.continuityCounter[idx] = static_cast<uint8_t>((header >> 24) & 0xF);
+}
+
+#if defined(TS_HEADERS_SSE2)
+// gathers the headers of four packets into the lanes of the register
+static __m128i gatherHeaders(const uint8_t* packets) {
+	return _mm_set_epi32(
+		static_cast<int>(loadHeader(packets + 3 * TS_PACKET_SIZE)),
+		static_cast<int>(loadHeader(packets + 2 * TS_PACKET_SIZE)),
+		static_cast<int>(loadHeader(packets + TS_PACKET_SIZE)),
+		static_cast<int>(loadHeader(packets))
+	);
+}
+
+// packs eight 32-bit lanes of values not greater than 0xFF to bytes
+static void storeBytes(uint8_t* out, const __m128i low, const __m128i high) {
+	const __m128i words = _mm_packs_epi32(low, high);
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(words, words));
+}
+
+void parseTsHeaders(const uint8_t* packets, const size_t count, const TsHeaderArrays& headers) {
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+	const __m128i bitMask = _mm_set1_epi32(0x1);
+	const __m128i pidHighMask = _mm_set1_epi32(0x1F00);
+	const __m128i counterMask = _mm_set1_epi32(0xF);
+	size_t idx = 0;
+	for (; idx + 8 <= count; idx += 8, packets += 8 * TS_PACKET_SIZE) {
+		const __m128i low = gatherHeaders(packets);
+		const __m128i high = gatherHeaders(packets + 4 * TS_PACKET_SIZE);
+		storeBytes(headers.syncByte + idx, _mm_and_si128(low, byteMask), _mm_and_si128(high, byteMask));
+		storeBytes(headers.payloadUnitStart + idx,
+			_mm_and_si128(_mm_srli_epi32(low, 14), bitMask), _mm_and_si128(_mm_srli_epi32(high, 14), bitMask));
+		storeBytes(headers.continuityCounter + idx,
+			_mm_and_si128(_mm_srli_epi32(low, 24), counterMask), _mm_and_si128(_mm_srli_epi32(high, 24), counterMask));
+		// the PID is not greater than 0x1FFF, so the signed saturation keeps it
+		const __m128i lowPid = _mm_or_si128(_mm_and_si128(low, pidHighMask), _mm_and_si128(_mm_srli_epi32(low, 16), byteMask));
+		const __m128i highPid = _mm_or_si128(_mm_and_si128(high, pidHighMask), _mm_and_si128(_mm_srli_epi32(high, 16), byteMask));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(headers.pid + idx), _mm_packs_epi32(lowPid, highPid));
+	}
+	for (; idx < count; ++idx, packets += TS_PACKET_SIZE) {
+		parseTsHeader(packets, headers, idx);
+	}
+}
+#else
+void parseTsHeaders(const uint8_t* packets, const size_t count, const TsHeaderArrays& headers) {
+	for (size_t idx = 0; idx < count; ++idx, packets += TS_PACKET_SIZE) {
+		parseTsHeader(packets, headers, idx);
+	}
+}
+#endif
+
+size_t parseTsHeaders(const VirtualPointer<uint8_t>& packets, const size_t count, const TsHeaderArrays& headers) {
+	VirtualPointer<uint8_t> packet = packets;
+	size_t idx = 0;
+	if (packet.bytesRemaining() < TS_HEADER_SIZE) {
+		return 0;
+	}
+	while (idx < count) {
+		size_t available;
+		size_t parsed;
+		const uint8_t* data = packet.contiguousData(available);
+		if (available >= TS_HEADER_SIZE) {
+			// the packets whose headers are inside the chunk
+			size_t run = (available - TS_HEADER_SIZE) / TS_PACKET_SIZE + 1;
+			if (run > count - idx) {
+				run = count - idx;
+			}
+			const TsHeaderArrays runHeaders{ headers.syncByte + idx, headers.payloadUnitStart + idx, headers.pid + idx, headers.continuityCounter + idx };
+			parseTsHeaders(data, run, runHeaders);
+			parsed = run;
+		}
+		else {
+			// the header crosses the border of the chunks
+			uint8_t header[TS_HEADER_SIZE];
+			memcpy(header, packet, TS_HEADER_SIZE);
+			parseTsHeader(header, headers, idx);
+			parsed = 1;
+		}
+		idx += parsed;
+		// the next header must be inside the data
+		if (packet.bytesRemaining() < parsed * TS_PACKET_SIZE + TS_HEADER_SIZE) {
+			break;
+		}
+		packet += parsed * TS_PACKET_SIZE;
+	}
+	return idx;
+}
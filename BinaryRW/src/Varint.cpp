@@ -0,0 +1,101 @@
+#include "pch.h"
+#include "Varint.h"
+#include "BitMask.h"
+
+#include <algorithm>
+#include <cstring>
+
+// MSVC does not define __BMI2__, but its /arch:AVX2 targets the processors that have BMI2 too
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define VARINT_BMI2
+#include <immintrin.h>
+#endif
+
+using std::size_t;
+
+constexpr uint8_t VARINT_CONTINUATION_BIT = 0x80;
+
+static size_t decodeVarintByBytes(const uint8_t* data, const size_t size, uint64_t& value) {
+	uint64_t result = 0;
+	const size_t maxSize = std::min(size, MAX_VARINT_SIZE);
+	for (size_t i = 0; i < maxSize; ++i) {
+		result |= static_cast<uint64_t>(data[i] & ~VARINT_CONTINUATION_BIT) << (7 * i);
+		if (!(data[i] & VARINT_CONTINUATION_BIT)) {
+			// the last byte of the longest varint keeps only the highest bit of the value
+			if (MAX_VARINT_SIZE - 1 == i && data[i] > 1) {
+				return 0;
+			}
+			value = result;
+			return i + 1;
+		}
+	}
+	return 0;
+}
+
+#if defined(_M_X64) || defined(__amd64__)
+// joins the 7-bit groups of the bytes of the little-endian word, the continuation bits must be cleared
+static uint64_t compactGroups(uint64_t word) {
+#if defined(VARINT_BMI2)
+	return _pext_u64(word, 0x7F7F7F7F7F7F7F7F);
+#else
+	word = ((word & 0x7F007F007F007F00) >> 1) | (word & 0x007F007F007F007F);
+	word = ((word & 0x3FFF00003FFF0000) >> 2) | (word & 0x00003FFF00003FFF);
+	return ((word & 0x0FFFFFFF00000000) >> 4) | (word & 0x000000000FFFFFFF);
+#endif
+}
+
+size_t decodeVarint(const uint8_t* data, const size_t size, uint64_t& value) {
+	if (size < MAX_VARINT_SIZE) {
+		return decodeVarintByBytes(data, size, value);
+	}
+	uint64_t word;
+	memcpy(&word, data, sizeof(word));
+	const uint64_t stopBits = ~word & 0x8080808080808080;
+	if (stopBits) {
+		// the count of the bits of the varint bytes
+		const size_t bits = countTrailingZeros(stopBits) + 1;
+		const uint64_t bytes = bits == 64 ? word : word & ((static_cast<uint64_t>(1) << bits) - 1);
+		value = compactGroups(bytes & 0x7F7F7F7F7F7F7F7F);
+		return bits / 8;
+	}
+	// the varint is longer than 8 bytes, the ninth byte keeps the bits 56 - 62 and the tenth one the bit 63
+	const uint64_t low = compactGroups(word & 0x7F7F7F7F7F7F7F7F);
+	if (!(data[8] & VARINT_CONTINUATION_BIT)) {
+		value = low | static_cast<uint64_t>(data[8]) << 56;
+		return 9;
+	}
+	if (data[9] > 1) {
+		return 0;
+	}
+	value = low | static_cast<uint64_t>(data[8] & ~VARINT_CONTINUATION_BIT) << 56 | static_cast<uint64_t>(data[9]) << 63;
+	return MAX_VARINT_SIZE;
+}
+#else
+size_t decodeVarint(const uint8_t* data, const size_t size, uint64_t& value) {
+	return decodeVarintByBytes(data, size, value);
+}
+#endif
+
+bool readVarint(VirtualPointer<uint8_t>& data, uint64_t& value) {
+	size_t available;
+	const uint8_t* contiguous = data.contiguousData(available);
+	size_t size;
+	if (available >= MAX_VARINT_SIZE) {
+		size = decodeVarint(contiguous, available, value);
+	}
+	else {
+		// the varint can cross the border of the chunks
+		uint8_t bytes[MAX_VARINT_SIZE];
+		const size_t count = std::min(MAX_VARINT_SIZE, data.bytesRemaining());
+		if (!count) {
+			return false;
+		}
+		memcpy(bytes, data, count);
+		size = decodeVarint(bytes, count, value);
+	}
+	if (!size) {
+		return false;
+	}
+	data += size;
+	return true;
+}
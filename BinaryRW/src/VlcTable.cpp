@@ -0,0 +1,118 @@
+#include "pch.h"
+#include "VlcTable.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using std::size_t;
+
+constexpr size_t VlcTable::MAX_CODE_LENGTH;
+constexpr size_t VlcTable::MAX_ROOT_BITS;
+
+VlcTable::VlcTable(const VlcCode* codes, const size_t count, const size_t rootBits, const bool multiSymbol) :
+	m_rootBits(rootBits)
+{
+	if (!rootBits || rootBits > MAX_ROOT_BITS) {
+		throw std::invalid_argument("The root table must be indexed by 1 to 16 bits");
+	}
+	m_entries.assign(static_cast<size_t>(1) << rootBits, Entry{ 0, 0, 0, 0 });
+	for (size_t i = 0; i < count; ++i) {
+		const VlcCode& code = codes[i];
+		if (!code.length || code.length > MAX_CODE_LENGTH) {
+			throw std::invalid_argument("The code length must be from 1 to 24 bits");
+		}
+		if (code.code >> code.length) {
+			throw std::invalid_argument("The code is longer than its length");
+		}
+		m_maxCodeLength = std::max(m_maxCodeLength, static_cast<size_t>(code.length));
+		if (code.length > rootBits) {
+			// the subtable of the prefix is indexed by the bits of its longest code after the prefix
+			Entry& link = m_entries[code.code >> (code.length - rootBits)];
+			if (link.firstLength) {
+				throw std::invalid_argument("The codes are not prefix-free");
+			}
+			link.length = std::max(link.length, static_cast<uint8_t>(code.length - rootBits));
+		}
+	}
+	const size_t rootSize = m_entries.size();
+	for (size_t i = 0; i < rootSize; ++i) {
+		if (m_entries[i].length) {
+			m_entries[i].value = static_cast<uint32_t>(m_entries.size());
+			m_entries.resize(m_entries.size() + (static_cast<size_t>(1) << m_entries[i].length), Entry{ 0, 0, 0, 0 });
+		}
+	}
+	for (size_t i = 0; i < count; ++i) {
+		const VlcCode& code = codes[i];
+		size_t first;
+		size_t bits;
+		if (code.length > rootBits) {
+			const Entry& link = m_entries[code.code >> (code.length - rootBits)];
+			const size_t suffixLength = code.length - rootBits;
+			first = link.value + ((code.code & LITTLE_BITS[suffixLength]) << (link.length - suffixLength));
+			bits = link.length - suffixLength;
+		}
+		else {
+			first = static_cast<size_t>(code.code) << (rootBits - code.length);
+			bits = rootBits - code.length;
+		}
+		const size_t last = first + (static_cast<size_t>(1) << bits);
+		for (size_t entry = first; entry < last; ++entry) {
+			if (m_entries[entry].firstLength || (entry < rootSize && m_entries[entry].length)) {
+				throw std::invalid_argument("The codes are not prefix-free");
+			}
+			m_entries[entry] = Entry{ code.symbol, 0, code.length, code.length };
+		}
+	}
+	if (multiSymbol) {
+		pairSymbols();
+	}
+}
+
+VlcTable VlcTable::fromCodeLengths(const uint8_t* lengths, const size_t symbolsCount, const size_t rootBits, const bool multiSymbol) {
+	size_t lengthsCount[MAX_CODE_LENGTH + 1] = {};
+	for (size_t symbol = 0; symbol < symbolsCount; ++symbol) {
+		if (lengths[symbol] > MAX_CODE_LENGTH) {
+			throw std::invalid_argument("The code length must be from 1 to 24 bits");
+		}
+		++lengthsCount[lengths[symbol]];
+	}
+	// the first code of every length as in RFC 1951
+	uint32_t nextCode[MAX_CODE_LENGTH + 1] = {};
+	uint32_t code = 0;
+	for (size_t length = 1; length <= MAX_CODE_LENGTH; ++length) {
+		code = (code + static_cast<uint32_t>(lengthsCount[length - 1] * (length > 1))) << 1;
+		nextCode[length] = code;
+	}
+	std::vector<VlcCode> codes;
+	codes.reserve(symbolsCount - lengthsCount[0]);
+	for (size_t symbol = 0; symbol < symbolsCount; ++symbol) {
+		if (lengths[symbol]) {
+			codes.push_back(VlcCode{ nextCode[lengths[symbol]]++, lengths[symbol], static_cast<uint16_t>(symbol) });
+		}
+	}
+	return VlcTable(codes.data(), codes.size(), rootBits, multiSymbol);
+}
+
+size_t VlcTable::getRootBits() const {
+	return m_rootBits;
+}
+
+size_t VlcTable::getMaxCodeLength() const {
+	return m_maxCodeLength;
+}
+
+void VlcTable::pairSymbols() {
+	const size_t rootSize = static_cast<size_t>(1) << m_rootBits;
+	for (size_t i = 0; i < rootSize; ++i) {
+		Entry& entry = m_entries[i];
+		if (!entry.firstLength || entry.firstLength >= m_rootBits) {
+			continue;
+		}
+		// the bits after the first code are the high bits of the index of the second one
+		const Entry& second = m_entries[(i << entry.firstLength) & LITTLE_BITS[m_rootBits]];
+		if (second.firstLength && entry.firstLength + second.firstLength <= m_rootBits) {
+			entry.secondSymbol = static_cast<uint16_t>(second.value);
+			entry.length = static_cast<uint8_t>(entry.firstLength + second.firstLength);
+		}
+	}
+}
@@ -1,7 +1,25 @@
 #include "pch.h"
 #include "ArraysTest.h"
+#include "AsyncBinaryReader.h"
+#include "BackwardBinaryReader.h"
 #include "BinaryReader.h"
 #include "BinaryWriter.h"
+#include "BitLayout.h"
+#include "BitstreamView.h"
+#include "EmulationPrevention.h"
+#include "FseTable.h"
+#include "PacketParser.h"
+#include "ProtobufReader.h"
+#include "RleBitPackedDecoder.h"
+#include "StreamBinaryReader.h"
+#include "TsHeaders.h"
+#include "Varint.h"
+#include "VlcTable.h"
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
 
 // input data is <bit endian> and <byte endian>
 #define BB false, true
@@ -2402,4 +2420,1549 @@ TEST(TestBinaryWriter, setDataInfiniteSizeWithIntermediateFlush) {
 	{
 		EXPECT_EQ(0xFF, chunk[i]);
 	}
-}
\ No newline at end of file
+}
+
+TEST(TestBinaryReader, HotPathStatistics) {
+	uint8_t memory[20] = { 0 };
+	BinaryReader<uint8_t> reader{ REVERSE_BYTES };
+	// the counters are kept only by the configurations defining BINARY_VIRTUALIZATION_STATISTICS
+	constexpr uint64_t counted = STATISTICS_ENABLED ? 1 : 0;
+
+	resetStatistics();
+	reader.setData(memory, sizeof(memory));
+	EXPECT_EQ(counted, getStatisticsSnapshot().cacheRefills);
+
+	size_t value;
+	EXPECT_TRUE(reader.readBits(60, value));
+	EXPECT_TRUE(reader.readBits(8, value));
+	EXPECT_EQ(2 * counted, getStatisticsSnapshot().cacheRefills);
+	EXPECT_EQ(0, getStatisticsSnapshot().slowPaths);
+
+	EXPECT_TRUE(reader.readBits(64, value));
+	const auto statistics = getStatisticsSnapshot();
+	EXPECT_EQ(3 * counted, statistics.cacheRefills);
+	EXPECT_EQ(counted, statistics.slowPaths);
+}
+
+template <class ByteOrder, class BitOrder>
+void StaticOrderMatchesRuntimeOrder(const reverse_bytes_t reverseBytes, const reverse_bits_t reverseBits) {
+	constexpr size_t size = 61;
+	uint8_t memory[size];
+	for (size_t i = 0; i < size; ++i) {
+		memory[i] = static_cast<uint8_t>(i * 37 + 11);
+	}
+	VirtualPointer<uint8_t> vMemory{};
+	vMemory.addChunk(memory, 13);
+	vMemory.addChunk(memory + 13, 3);
+	vMemory.addChunk(memory + 16, size - 16);
+
+	BinaryReader<uint8_t, ByteOrder, BitOrder> staticReader{};
+	BinaryReader<uint8_t, ByteOrder, BitOrder> staticVirtualReader{};
+	BinaryReader<uint8_t> runtimeReader(reverseBytes, reverseBits);
+	staticReader.setData(memory, size);
+	staticVirtualReader.setData(vMemory, size);
+	runtimeReader.setData(memory, size);
+
+	size_t expected;
+	size_t value;
+	unsigned long long virtualValue;
+	for (size_t count = 1; runtimeReader.readBits(count, expected); count = count % 64 + 7) {
+		EXPECT_TRUE(staticReader.lookBits(count, value));
+		EXPECT_EQ(expected, value);
+		EXPECT_TRUE(staticReader.readBits(count, value));
+		EXPECT_EQ(expected, value);
+		EXPECT_TRUE(staticVirtualReader.readBits(count, virtualValue));
+		EXPECT_EQ(expected, virtualValue);
+	}
+	EXPECT_EQ(runtimeReader.getReadBitsCount(), staticReader.getReadBitsCount());
+	EXPECT_EQ(runtimeReader.getReadBitsCount(), staticVirtualReader.getReadBitsCount());
+}
+
+TEST(TestBinaryReader, StaticOrderMatchesRuntimeOrder) {
+	StaticOrderMatchesRuntimeOrder<ReversedBytes, DirectBits>(REVERSE_BYTES, !REVERSE_BITS);
+	StaticOrderMatchesRuntimeOrder<ReversedBytes, ReversedBits>(REVERSE_BYTES, REVERSE_BITS);
+	StaticOrderMatchesRuntimeOrder<DirectBytes, DirectBits>(!REVERSE_BYTES, !REVERSE_BITS);
+	StaticOrderMatchesRuntimeOrder<DirectBytes, ReversedBits>(!REVERSE_BYTES, REVERSE_BITS);
+}
+
+// splits the memory into the chunks of a virtual pointer, the first chunk has one element
+// and every next one length * multiplier % maxChunk + 1 elements (1, 2, ..., maxChunk, 1, ... for the multiplier 1)
+template <class T>
+static VirtualPointer<T> splitIntoChunks(T* memory, const size_t size, const size_t maxChunk, const size_t multiplier = 1) {
+	VirtualPointer<T> vMemory{};
+	for (size_t offset = 0, length = 1; offset < size; offset += length, length = length * multiplier % maxChunk + 1) {
+		vMemory.addChunk(memory + offset, std::min(length, size - offset));
+	}
+	return vMemory;
+}
+
+TEST(TestBinaryReader, VirtualReadAcrossSmallChunks) {
+	constexpr size_t size = 97;
+	uint8_t memory[size];
+	for (size_t i = 0; i < size; ++i) {
+		memory[i] = static_cast<uint8_t>(i * 73 + 5);
+	}
+	// chunks of 1, 2, ..., 12 bytes so that words are stitched at every position of a border
+	VirtualPointer<uint8_t> vMemory = splitIntoChunks(memory, size, 12);
+
+	BinaryReader<uint8_t> reader{ REVERSE_BYTES };
+	BinaryReader<uint8_t> virtualReader{ REVERSE_BYTES };
+	reader.setData(memory, size);
+	virtualReader.setData(vMemory, size);
+
+	size_t expected;
+	size_t value;
+	for (size_t count = 3; reader.lookBits(count, expected); count = count % 64 + 11) {
+		EXPECT_TRUE(virtualReader.lookBits(count, value));
+		EXPECT_EQ(expected, value);
+		EXPECT_TRUE(reader.readBits(count, expected));
+		EXPECT_TRUE(virtualReader.readBits(count, value));
+		EXPECT_EQ(expected, value);
+		EXPECT_TRUE(reader.skipBits(count / 3));
+		EXPECT_TRUE(virtualReader.skipBits(count / 3));
+	}
+	EXPECT_EQ(reader.getReadBitsCount(), virtualReader.getReadBitsCount());
+}
+
+TEST(TestBinaryReader, VirtualReadOfWideElements) {
+	constexpr size_t size = 61;
+	uint8_t memory[size];
+	uint16_t elements[size];
+	for (size_t i = 0; i < size; ++i) {
+		memory[i] = static_cast<uint8_t>(i * 73 + 5);
+		// the element gives its lowest byte, the highest one is not read
+		elements[i] = static_cast<uint16_t>(0xA500 | memory[i]);
+	}
+	// chunks of two elements split every word
+	VirtualPointer<uint16_t> vElements{};
+	for (size_t offset = 0; offset < size; offset += 2) {
+		vElements.addChunk(elements + offset, std::min<size_t>(2, size - offset));
+	}
+
+	for (const bool reverseBytes : { true, false }) {
+		BinaryReader<uint8_t> reader{ reverseBytes };
+		BinaryReader<uint16_t> virtualReader{ reverseBytes };
+		reader.setData(memory, size);
+		virtualReader.setData(vElements, size);
+		size_t expected;
+		size_t value;
+		for (size_t count = 3; reader.lookBits(count, expected); count = count % 64 + 11) {
+			EXPECT_TRUE(virtualReader.lookBits(count, value));
+			EXPECT_EQ(expected, value);
+			EXPECT_TRUE(reader.readBits(count, expected));
+			EXPECT_TRUE(virtualReader.readBits(count, value));
+			EXPECT_EQ(expected, value);
+			// the skips over the next words
+			EXPECT_EQ(reader.skipBits(count * 2), virtualReader.skipBits(count * 2));
+		}
+		EXPECT_EQ(reader.getReadBitsCount(), virtualReader.getReadBitsCount());
+	}
+}
+
+template <class Reader>
+void ReadRefilledBits(Reader& reader, Reader& checkedReader, const size_t sizeInBits) {
+	size_t expected;
+	size_t count = 1;
+	while (true) {
+		reader.refill();
+		const size_t remainBits = sizeInBits - reader.getReadBitsCount();
+		EXPECT_GE(reader.getCachedBitsCount(), std::min<size_t>(Reader::REFILLED_BITS, remainBits));
+		if (!remainBits) {
+			EXPECT_FALSE(checkedReader.readBits(1, expected));
+			return;
+		}
+		// takes up to REFILLED_BITS bits by several reads
+		size_t taken = 0;
+		while (taken + count <= std::min<size_t>(Reader::REFILLED_BITS, reader.getCachedBitsCount())) {
+			EXPECT_TRUE(checkedReader.readBits(count, expected));
+			EXPECT_EQ(expected, reader.lookBitsUnchecked(count));
+			EXPECT_EQ(expected, reader.readBitsUnchecked(count));
+			taken += count;
+			count = count % 23 + 2;
+		}
+		if (taken < reader.getCachedBitsCount()) {
+			reader.skipBitsUnchecked(1);
+			EXPECT_TRUE(checkedReader.skipBits(1));
+		}
+	}
+}
+
+template <class Reader>
+void RefillAndUncheckedReading(const Reader& prototype, const uint8_t* memory, const size_t size) {
+	VirtualPointer<uint8_t> vMemory{};
+	for (size_t offset = 0, length = 5; offset < size; offset += length, length = length * 6) {
+		vMemory.addChunk(const_cast<uint8_t*>(memory) + offset, std::min(length, size - offset));
+	}
+
+	Reader reader = prototype;
+	Reader checkedReader = prototype;
+	reader.setData(memory, size);
+	checkedReader.setData(memory, size);
+	// no bits of the full cache
+	EXPECT_EQ(0, reader.lookBitsUnchecked(0));
+	EXPECT_EQ(0, reader.readBitsUnchecked(0));
+	ReadRefilledBits(reader, checkedReader, multiplyBy8(size));
+	EXPECT_EQ(multiplyBy8(size), reader.getReadBitsCount());
+
+	reader.setData(vMemory, size);
+	checkedReader.setData(memory, size);
+	ReadRefilledBits(reader, checkedReader, multiplyBy8(size));
+	EXPECT_EQ(multiplyBy8(size), reader.getReadBitsCount());
+
+	// the checked functions work correctly after refill
+	for (size_t i = 0; i < 2; ++i) {
+		if (i) {
+			reader.setData(vMemory, size);
+		}
+		else {
+			reader.setData(memory, size);
+		}
+		checkedReader.setData(memory, size);
+		size_t value;
+		size_t expected;
+		for (size_t count = 5; checkedReader.readBits(count, expected); count = count % 64 + 9) {
+			reader.refill();
+			EXPECT_TRUE(reader.lookBits(count, value));
+			EXPECT_EQ(expected, value);
+			EXPECT_TRUE(reader.readBits(count, value));
+			EXPECT_EQ(expected, value);
+			reader.refill();
+			const auto checkpoint = reader.mark();
+			reader.skipBits(count + 70);
+			reader.rewind(checkpoint);
+			// the skips over the next words
+			const size_t skipped = count * 3 % 150;
+			EXPECT_EQ(checkedReader.skipBits(skipped), reader.skipBits(skipped));
+		}
+		EXPECT_EQ(checkedReader.getReadBitsCount(), reader.getReadBitsCount());
+	}
+}
+
+TEST(TestBinaryReader, RefillAndUncheckedReading) {
+	constexpr size_t size = 83;
+	uint8_t memory[size];
+	for (size_t i = 0; i < size; ++i) {
+		memory[i] = static_cast<uint8_t>(i * 151 + 7);
+	}
+	// the short data begin with the groups of other sizes than the word
+	for (const size_t dataSize : { size, size_t(23), size_t(12), size_t(9), size_t(5) }) {
+		RefillAndUncheckedReading(BinaryReader<uint8_t, ReversedBytes, DirectBits>{}, memory, dataSize);
+		// the bytes of the words are reversed, so refill() appends the next bytes to the unread ones
+		RefillAndUncheckedReading(BinaryReader<uint8_t, DirectBytes, DirectBits>{}, memory, dataSize);
+		RefillAndUncheckedReading(BinaryReader<uint8_t, DirectBytes, ReversedBits>{}, memory, dataSize);
+		RefillAndUncheckedReading(BinaryReader<uint8_t>{ !REVERSE_BYTES }, memory, dataSize);
+		RefillAndUncheckedReading(BinaryReader<uint8_t>{ !REVERSE_BYTES, REVERSE_BITS }, memory, dataSize);
+	}
+}
+
+TEST(TestBinaryReader, ExpGolombCodes) {
+	// writes ue(v) codes of 0..299 one after another and the same values as se(v)
+	constexpr size_t count = 300;
+	uint8_t memory[2048] = { 0 };
+	VirtualPointer<uint8_t> vMemory = splitIntoChunks(memory, sizeof(memory), 5);
+	BinaryWriter<uint8_t> writer(REVERSE_BYTES, !REVERSE_BITS);
+	writer.setData(memory, sizeof(memory));
+	size_t written = 0;
+	for (size_t i = 0; i < 2 * count; ++i) {
+		const size_t codeNum = i % count;
+		const size_t leadingZeros = countLeadingZeros(1) - countLeadingZeros(codeNum + 1);
+		if (leadingZeros) {
+			writer.writeBits(leadingZeros, 0);
+		}
+		writer.writeBits(leadingZeros + 1, codeNum + 1);
+		written += 2 * leadingZeros + 1;
+	}
+	// the longest supported code and the too long one
+	writer.writeBits(31, 0);
+	writer.writeBits(32, 0xFFFFFFFF);
+	writer.writeBits(32, 0);
+	writer.writeBits(1, 1);
+	written += 63 + 33;
+	writer.flush();
+	const size_t size = divideBy8(written + 7);
+
+	BinaryReader<uint8_t> reader{ REVERSE_BYTES };
+	BinaryReader<uint8_t, ReversedBytes, DirectBits> virtualReader{};
+	reader.setData(memory, size);
+	virtualReader.setData(vMemory, size);
+	size_t value;
+	int32_t signedValue;
+	for (size_t i = 0; i < count; ++i) {
+		EXPECT_TRUE(reader.readUE(value));
+		EXPECT_EQ(i, value);
+		EXPECT_TRUE(virtualReader.readUE(value));
+		EXPECT_EQ(i, value);
+	}
+	for (size_t i = 0; i < count; ++i) {
+		const int32_t expected = (i & 1) ? static_cast<int32_t>((i + 1) / 2) : -static_cast<int32_t>(i / 2);
+		EXPECT_TRUE(reader.readSE(signedValue));
+		EXPECT_EQ(expected, signedValue);
+		EXPECT_TRUE(virtualReader.readSE(signedValue));
+		EXPECT_EQ(expected, signedValue);
+	}
+	EXPECT_TRUE(reader.readUE(value));
+	EXPECT_EQ(0xFFFFFFFEu, value);
+	const auto readBitsCount = reader.getReadBitsCount();
+	EXPECT_FALSE(reader.readUE(value));
+	EXPECT_EQ(readBitsCount, reader.getReadBitsCount());
+}
+
+TEST(TestEmulationPrevention, RbspView) {
+	// NAL data with emulation prevention bytes at the beginning, at the borders of 16-byte blocks,
+	// in a row and at the end, and with the patterns that must be kept
+	uint8_t nal[200];
+	for (size_t i = 0; i < sizeof(nal); ++i) {
+		nal[i] = static_cast<uint8_t>(i * 29 + 1) | 0x10;
+	}
+	const size_t epbPositions[] = { 2, 17, 31, 35, 47, 50, 53, 64, 99, 199 };
+	for (const size_t idx : epbPositions) {
+		nal[idx - 2] = 0;
+		nal[idx - 1] = 0;
+		nal[idx] = 0x03;
+	}
+	// 00 03 and 00 00 04 are kept
+	nal[120] = 0; nal[121] = 0x03;
+	nal[140] = 0; nal[141] = 0; nal[142] = 0x04;
+
+	std::vector<uint8_t> expected;
+	for (size_t i = 0; i < sizeof(nal); ++i) {
+		if (std::find(std::begin(epbPositions), std::end(epbPositions), i) == std::end(epbPositions)) {
+			expected.push_back(nal[i]);
+		}
+	}
+
+	EXPECT_EQ(31, findEmulationPreventionByte(nal, 18, sizeof(nal)));
+	EXPECT_EQ(sizeof(nal) - 1, findEmulationPreventionByte(nal, 100, sizeof(nal) - 1));
+
+	VirtualPointer<uint8_t> rbsp{};
+	const size_t rbspSize = addRbspChunks(rbsp, nal, sizeof(nal));
+	EXPECT_EQ(expected.size(), rbspSize);
+	EXPECT_EQ(expected.size(), rbsp.bytesRemaining());
+	EXPECT_EQ(0, memcmp(expected.data(), rbsp, rbspSize));
+
+	BinaryReader<uint8_t> reader{ REVERSE_BYTES };
+	reader.setData(rbsp, rbspSize);
+	size_t value;
+	for (size_t i = 0; i < rbspSize; ++i) {
+		EXPECT_TRUE(reader.readBits(8, value));
+		EXPECT_EQ(expected[i], value);
+	}
+	EXPECT_FALSE(reader.readBits(1, value));
+}
+
+TEST(TestBinaryReader, SkipWholeWords) {
+	constexpr size_t size = 10000;
+	// the data is allocated by its exact size, so reading after its end is found by the address sanitizer
+	std::unique_ptr<uint8_t[]> memory(new uint8_t[size]);
+	for (size_t i = 0; i < size; ++i) {
+		memory[i] = static_cast<uint8_t>(i * 7 + i / 256);
+	}
+	VirtualPointer<uint8_t> vMemory = splitIntoChunks(memory.get(), size, 500, 17);
+
+	BinaryReader<uint8_t> rawReader{ REVERSE_BYTES };
+	BinaryReader<uint8_t> virtualReader{ REVERSE_BYTES };
+	for (auto reader : { &rawReader, &virtualReader }) {
+		size_t value;
+		// the skip is longer than 65535 bits
+		reader == &rawReader ? reader->setData(memory.get(), size) : reader->setData(vMemory, size);
+		EXPECT_TRUE(reader->readBits(4, value));
+		EXPECT_TRUE(reader->skipBits(8 * 9000 + 4));
+		EXPECT_TRUE(reader->readBits(8, value));
+		EXPECT_EQ(memory[9001], value);
+
+		// the skip crosses whole words and ends in the last not full cache at the end of the memory
+		constexpr size_t tailSize = 100;
+		reader == &rawReader ? reader->setData(memory.get() + size - tailSize, tailSize) : reader->setData(vMemory + (size - tailSize), tailSize);
+		EXPECT_TRUE(reader->readBits(4, value));
+		EXPECT_TRUE(reader->skipBits(8 * (tailSize - 4) + 4));
+		for (size_t i = size - 3; i < size; ++i) {
+			EXPECT_TRUE(reader->readBits(8, value));
+			EXPECT_EQ(memory[i], value);
+		}
+		EXPECT_FALSE(reader->readBits(1, value));
+		EXPECT_EQ(8 * tailSize, reader->getReadBitsCount());
+	}
+}
+
+TEST(TestBinaryReader, ReadView) {
+	constexpr size_t size = 45;
+	uint8_t memory[size];
+	for (size_t i = 0; i < size; ++i) {
+		memory[i] = static_cast<uint8_t>(i);
+	}
+	VirtualPointer<uint8_t> vMemory{};
+	vMemory.addChunk(memory, 10);
+	vMemory.addChunk(memory + 10, 4);
+	vMemory.addChunk(memory + 14, size - 14);
+
+	BinaryReader<uint8_t> rawReader{ REVERSE_BYTES };
+	BinaryReader<uint8_t> virtualReader{ REVERSE_BYTES };
+	rawReader.setData(memory, size);
+	virtualReader.setData(vMemory, size);
+	for (auto reader : { &rawReader, &virtualReader }) {
+		size_t value;
+		VirtualPointer<uint8_t> view{};
+		EXPECT_TRUE(reader->readBits(4, value));
+		EXPECT_FALSE(reader->readView(2, view));
+		EXPECT_TRUE(reader->readBits(12, value));
+		EXPECT_EQ(0x001, value);
+
+		// the view crosses the cache and the chunks
+		EXPECT_TRUE(reader->readView(20, view));
+		EXPECT_EQ(20, view.bytesRemaining());
+		EXPECT_EQ(0, memcmp(memory + 2, view, 20));
+		EXPECT_TRUE(reader->readBits(8, value));
+		EXPECT_EQ(22, value);
+
+		EXPECT_TRUE(reader->readView(0, view));
+		EXPECT_EQ(0, view.bytesRemaining());
+
+		// the tail of the data is in a not full cache
+		EXPECT_TRUE(reader->skipBits(8 * 17));
+		EXPECT_TRUE(reader->readBits(8, value));
+		EXPECT_EQ(40, value);
+		EXPECT_FALSE(reader->readView(5, view));
+		EXPECT_TRUE(reader->readView(4, view));
+		EXPECT_EQ(0, memcmp(memory + 41, view, 4));
+		EXPECT_FALSE(reader->readBits(1, value));
+	}
+
+	// the bytes of the words are reversed, so the memory is not the view of the data
+	BinaryReader<uint8_t> reversedWordsReader{ !REVERSE_BYTES };
+	reversedWordsReader.setData(memory, size);
+	VirtualPointer<uint8_t> view{};
+	EXPECT_FALSE(reversedWordsReader.readView(4, view));
+	EXPECT_TRUE(reversedWordsReader.hasError());
+	EXPECT_EQ(0, reversedWordsReader.getReadBitsCount());
+}
+
+TEST(TestBinaryReader, MarkAndRewind) {
+	constexpr size_t size = 37;
+	uint8_t memory[size];
+	for (size_t i = 0; i < size; ++i) {
+		memory[i] = static_cast<uint8_t>(3 * i + 1);
+	}
+	VirtualPointer<uint8_t> vMemory{};
+	vMemory.addChunk(memory, 5);
+	vMemory.addChunk(memory + 5, 3);
+	vMemory.addChunk(memory + 8, size - 8);
+
+	BinaryReader<uint8_t> rawReader{ REVERSE_BYTES };
+	BinaryReader<uint8_t> virtualReader{ REVERSE_BYTES };
+	rawReader.setData(memory, size);
+	virtualReader.setData(vMemory, size);
+	for (auto reader : { &rawReader, &virtualReader }) {
+		size_t expected;
+		size_t value;
+		EXPECT_TRUE(reader->readBits(13, value));
+		const auto checkpoint = reader->mark();
+		EXPECT_TRUE(reader->lookBits(40, expected));
+
+		// the speculative reading crosses the cache and the chunks
+		EXPECT_TRUE(reader->readBits(7, value));
+		EXPECT_TRUE(reader->skipBits(8 * 20 + 3));
+		EXPECT_TRUE(reader->readBits(30, value));
+		reader->rewind(checkpoint);
+		EXPECT_EQ(13, reader->getReadBitsCount());
+		EXPECT_TRUE(reader->readBits(40, value));
+		EXPECT_EQ(expected, value);
+
+		// a checkpoint can be restored many times
+		reader->rewind(checkpoint);
+		EXPECT_TRUE(reader->skipBits(8 * size - 13 - 5));
+		EXPECT_TRUE(reader->readBits(5, value));
+		EXPECT_EQ(memory[size - 1] & 0x1F, value);
+		EXPECT_FALSE(reader->readBits(1, value));
+		reader->rewind(checkpoint);
+		EXPECT_TRUE(reader->readBits(40, value));
+		EXPECT_EQ(expected, value);
+	}
+}
+
+TEST(TestVlcTable, DecodeCanonicalCodes) {
+	// the canonical codes of the lengths, the codes of the symbols 8, 9, 10 and 11 have the same 5-bit prefix 11101
+	const uint8_t lengths[13] = { 2, 3, 3, 3, 3, 4, 4, 5, 6, 10, 11, 11, 0 };
+	const uint32_t codes[12] = { 0x0, 0x2, 0x3, 0x4, 0x5, 0xC, 0xD, 0x1C, 0x3A, 0x3B0, 0x762, 0x763 };
+	constexpr size_t count = 500;
+	uint8_t memory[1024] = { 0 };
+	VirtualPointer<uint8_t> vMemory = splitIntoChunks(memory, sizeof(memory), 3);
+	BinaryWriter<uint8_t> writer(REVERSE_BYTES, !REVERSE_BITS);
+	writer.setData(memory, sizeof(memory));
+	size_t written = 0;
+	for (size_t i = 0; i < count; ++i) {
+		const size_t symbol = i * 7 % 12;
+		writer.writeBits(lengths[symbol], codes[symbol]);
+		written += lengths[symbol];
+	}
+	// the prefix that is not a code
+	writer.writeBits(5, 0x1F);
+	written += 5;
+	writer.flush();
+	const size_t size = divideBy8(written + 7);
+
+	const VlcTable table = VlcTable::fromCodeLengths(lengths, 13, 5);
+	const VlcTable multiSymbolTable = VlcTable::fromCodeLengths(lengths, 13, 7, true);
+	EXPECT_EQ(11, table.getMaxCodeLength());
+	BinaryReader<uint8_t> reader{ REVERSE_BYTES };
+	BinaryReader<uint8_t, ReversedBytes, DirectBits> virtualReader{};
+	reader.setData(memory, size);
+	virtualReader.setData(vMemory, size);
+	uint16_t symbol;
+	for (size_t i = 0; i < count; ++i) {
+		EXPECT_TRUE(table.decode(reader, symbol));
+		EXPECT_EQ(i * 7 % 12, symbol);
+	}
+	uint16_t symbols[2];
+	size_t lookups = 0;
+	for (size_t i = 0; i < count; ++lookups) {
+		const size_t decoded = multiSymbolTable.decodeSymbols(virtualReader, symbols);
+		EXPECT_TRUE(decoded == 1 || decoded == 2);
+		for (size_t j = 0; j < decoded; ++j, ++i) {
+			EXPECT_EQ(i * 7 % 12, symbols[j]);
+		}
+	}
+	EXPECT_GT(count, lookups);
+	const auto readBitsCount = reader.getReadBitsCount();
+	EXPECT_FALSE(table.decode(reader, symbol));
+	EXPECT_EQ(readBitsCount, reader.getReadBitsCount());
+	EXPECT_EQ(0, multiSymbolTable.decodeSymbols(virtualReader, symbols));
+
+	// the readers without REVERSE_BYTES load the words with the reversed bytes, the last shorter word is reversed too,
+	// so the same codes are placed in the memory by words
+	uint8_t reversedWords[sizeof(memory)];
+	for (size_t first = 0; first < size; first += sizeof(size_t)) {
+		const size_t wordSize = std::min(sizeof(size_t), size - first);
+		for (size_t i = 0; i < wordSize; ++i) {
+			reversedWords[first + wordSize - 1 - i] = memory[first + i];
+		}
+	}
+	VirtualPointer<uint8_t> vReversedWords{};
+	vReversedWords.addChunk(reversedWords, 13);
+	vReversedWords.addChunk(reversedWords + 13, size - 13);
+	BinaryReader<uint8_t, DirectBytes, DirectBits> directReader{};
+	BinaryReader<uint8_t> runtimeReader{ !REVERSE_BYTES };
+	directReader.setData(reversedWords, size);
+	runtimeReader.setData(vReversedWords, size);
+	for (size_t i = 0; i < count; ++i) {
+		EXPECT_TRUE(table.decode(directReader, symbol));
+		EXPECT_EQ(i * 7 % 12, symbol);
+	}
+	EXPECT_FALSE(table.decode(directReader, symbol));
+	for (size_t i = 0; i < count;) {
+		const size_t decoded = multiSymbolTable.decodeSymbols(runtimeReader, symbols);
+		ASSERT_TRUE(decoded == 1 || decoded == 2);
+		for (size_t j = 0; j < decoded; ++j, ++i) {
+			EXPECT_EQ(i * 7 % 12, symbols[j]);
+		}
+	}
+	EXPECT_EQ(0, multiSymbolTable.decodeSymbols(runtimeReader, symbols));
+
+	// the code can not be decoded from the not full tail of the data
+	const uint8_t tail = 0xEC;
+	reader.setData(&tail, 1);
+	EXPECT_FALSE(table.decode(reader, symbol));
+	EXPECT_TRUE(reader.skipBits(4));
+	EXPECT_TRUE(table.decode(reader, symbol));
+	EXPECT_EQ(5, symbol);
+
+	const VlcCode notPrefixFree[2] = { { 0x1, 1, 0 }, { 0x2, 2, 1 } };
+	EXPECT_THROW(VlcTable(notPrefixFree, 2, 4), std::invalid_argument);
+	const VlcCode tooLong[1] = { { 0x0, 25, 0 } };
+	EXPECT_THROW(VlcTable(tooLong, 1, 4), std::invalid_argument);
+}
+
+TEST(TestBitLayout, TsHeader) {
+	// sync byte, transport error indicator, payload unit start indicator, priority, PID, scrambling control, adaptation field control, continuity counter
+	using TsHeader = BitLayout<8, 1, 1, 1, 13, 2, 2, 4>;
+	static_assert(32 == TsHeader::TOTAL_BITS, "The TS header is 32 bits long");
+	static_assert(0x1FFF == TsHeader::get<4>(0x471FFF10), "The PID of the null packet");
+	static_assert(1 == TsHeader::get<6>(0x471FFF10), "The payload only packet");
+
+	constexpr size_t count = 5;
+	uint8_t memory[4 * count + 1] = { 0 };
+	VirtualPointer<uint8_t> vMemory{};
+	vMemory.addChunk(memory, 3);
+	vMemory.addChunk(memory + 3, 7);
+	vMemory.addChunk(memory + 10, sizeof(memory) - 10);
+	BinaryWriter<uint8_t> writer(REVERSE_BYTES, !REVERSE_BITS);
+	writer.setData(memory, sizeof(memory));
+	writer.writeBits(4, 0xA);
+	for (size_t i = 0; i < count; ++i) {
+		// the values wider than their fields are cut
+		EXPECT_TRUE(TsHeader::write(writer, TsHeader::Fields{ { 0x47, i & 1, 0, 1, 0x100 + i, 0x6, 0x3, i + 0x10 } }));
+	}
+	writer.flush();
+
+	BinaryReader<uint8_t> reader{ REVERSE_BYTES };
+	BinaryReader<uint8_t, ReversedBytes, DirectBits> virtualReader{};
+	reader.setData(memory, sizeof(memory));
+	virtualReader.setData(vMemory, sizeof(memory));
+	size_t value;
+	EXPECT_TRUE(reader.readBits(4, value));
+	EXPECT_TRUE(virtualReader.skipBits(4));
+	TsHeader::Fields fields;
+	TsHeader::Fields virtualFields;
+	for (size_t i = 0; i < count; ++i) {
+		const TsHeader::Fields expected{ { 0x47, i & 1, 0, 1, 0x100 + i, 0x2, 0x3, i } };
+		EXPECT_TRUE(TsHeader::read(reader, fields));
+		EXPECT_EQ(expected, fields);
+		EXPECT_TRUE(TsHeader::read(virtualReader, virtualFields));
+		EXPECT_EQ(expected, virtualFields);
+	}
+	EXPECT_FALSE(TsHeader::read(reader, fields));
+	EXPECT_TRUE(reader.readBits(4, value));
+	EXPECT_EQ(0, value);
+}
+
+TEST(TestTsHeaders, BatchParsing) {
+	// 21 packets: two full SIMD batches and a tail, the last packet is cut after its header
+	constexpr size_t count = 21;
+	constexpr size_t size = (count - 1) * TS_PACKET_SIZE + TS_HEADER_SIZE + 10;
+	std::vector<uint8_t> memory(size, 0xFF);
+	for (size_t i = 0; i < count; ++i) {
+		uint8_t* header = memory.data() + i * TS_PACKET_SIZE;
+		const size_t pid = (i * 397) & 0x1FFF;
+		header[0] = i == 5 ? 0x46 : TS_SYNC_BYTE;
+		header[1] = static_cast<uint8_t>(((i & 1) << 7) | ((i % 3 == 0) << 6) | (pid >> 8));
+		header[2] = static_cast<uint8_t>(pid);
+		header[3] = static_cast<uint8_t>(0x10 | (i & 0xF) | (i << 4));
+	}
+	// the packets are split into chunks of different sizes, the headers of some packets cross the borders
+	VirtualPointer<uint8_t> vMemory{};
+	for (size_t offset = 0, length = 2; offset < size; offset += length, length = length * 7 % 500 + 1) {
+		vMemory.addChunk(memory.data() + offset, std::min(length, size - offset));
+	}
+
+	uint8_t syncByte[count + 1];
+	uint8_t payloadUnitStart[count + 1];
+	uint16_t pid[count + 1];
+	uint8_t continuityCounter[count + 1];
+	const TsHeaderArrays headers{ syncByte, payloadUnitStart, pid, continuityCounter };
+	const auto check = [&]() {
+		for (size_t i = 0; i < count; ++i) {
+			EXPECT_EQ(i == 5 ? 0x46 : TS_SYNC_BYTE, syncByte[i]);
+			EXPECT_EQ(i % 3 == 0, payloadUnitStart[i]);
+			EXPECT_EQ((i * 397) & 0x1FFF, pid[i]);
+			EXPECT_EQ(i & 0xF, continuityCounter[i]);
+		}
+	};
+	parseTsHeaders(memory.data(), count, headers);
+	check();
+	memset(pid, 0, sizeof(pid));
+	EXPECT_EQ(count, parseTsHeaders(vMemory, count + 1, headers));
+	check();
+	EXPECT_EQ(7, parseTsHeaders(vMemory, 7, headers));
+	EXPECT_EQ(0, parseTsHeaders(VirtualPointer<uint8_t>{}, count, headers));
+}
+
+TEST(TestPacketParser, ParallelParsingKeepsOrder) {
+	constexpr size_t packetSize = 188;
+	constexpr size_t count = 1000;
+	// the tail shorter than a packet is not parsed
+	std::vector<uint8_t> memory(count * packetSize + 100);
+	for (size_t i = 0; i < memory.size(); ++i) {
+		memory[i] = static_cast<uint8_t>(i * 31 + i / packetSize);
+	}
+	VirtualPointer<uint8_t> vMemory = splitIntoChunks(memory.data(), memory.size(), 1000, 13);
+	// the sum of the 16-bit words of the packet after its 4-bit prefix
+	const auto parse = [](BinaryReader<uint8_t>& reader, const size_t) {
+		size_t sum = 0;
+		size_t value;
+		reader.skipBits(4);
+		while (reader.readBits(16, value)) {
+			sum += value;
+		}
+		return sum;
+	};
+	BinaryReader<uint8_t> reader{ REVERSE_BYTES };
+	std::vector<size_t> expected;
+	for (size_t i = 0; i < count; ++i) {
+		reader.setData(memory.data() + i * packetSize, packetSize);
+		expected.push_back(parse(reader, i));
+	}
+
+	ThreadPool pool(4);
+	EXPECT_EQ(4, pool.getThreadsCount());
+	EXPECT_EQ(expected, parsePackets<size_t>(pool, reader, memory.data(), memory.size(), packetSize, parse));
+	EXPECT_EQ(expected, parsePackets<size_t>(pool, reader, vMemory, memory.size(), packetSize, parse));
+	EXPECT_EQ(expected, parsePackets<size_t>(pool, reader, vMemory, memory.size(), packetSize, parse, 7));
+
+	const auto throwing = [](BinaryReader<uint8_t>&, const size_t idx) -> size_t {
+		if (idx == 500) {
+			throw std::runtime_error("The packet is broken");
+		}
+		return idx;
+	};
+	EXPECT_THROW(parsePackets<size_t>(pool, reader, memory.data(), memory.size(), packetSize, throwing), std::runtime_error);
+	// the pool is usable after the exception
+	EXPECT_EQ(expected, parsePackets<size_t>(pool, reader, memory.data(), memory.size(), packetSize, parse));
+	// the tasks queued by others and their exceptions are left to the pool
+	std::atomic<bool> released{ false };
+	pool.run([&released]() {
+		while (!released) {
+			std::this_thread::yield();
+		}
+		throw std::runtime_error("The task of another caller");
+	});
+	EXPECT_EQ(expected, parsePackets<size_t>(pool, reader, vMemory, memory.size(), packetSize, parse));
+	released = true;
+	EXPECT_THROW(pool.wait(), std::runtime_error);
+
+	EXPECT_THROW(parsePackets<size_t>(pool, reader, memory.data(), memory.size(), 0, parse), std::invalid_argument);
+	EXPECT_THROW(parsePackets<size_t>(pool, reader, vMemory, memory.size(), 0, parse), std::invalid_argument);
+}
+
+// appends the varint of the value to data
+static void encodeVarint(std::vector<uint8_t>& data, uint64_t value) {
+	for (; value >= 0x80; value >>= 7) {
+		data.push_back(static_cast<uint8_t>(value | 0x80));
+	}
+	data.push_back(static_cast<uint8_t>(value));
+}
+
+TEST(TestVarint, DecodeVarints) {
+	const uint64_t values[] = { 0, 1, 127, 128, 300, 0x3FFF, 0x4000, 0xFFFFFFFF, 0x00FFFFFFFFFFFFFF, 0x0100000000000000, 0x7FFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF };
+	std::vector<uint8_t> memory;
+	for (const uint64_t value : values) {
+		encodeVarint(memory, value);
+	}
+	// the varint longer than 64 bits and the unfinished one
+	const size_t brokenOffset = memory.size();
+	memory.insert(memory.end(), { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02 });
+	memory.insert(memory.end(), { 0xFF, 0xFF });
+
+	size_t offset = 0;
+	uint64_t value;
+	for (const uint64_t expected : values) {
+		const size_t size = decodeVarint(memory.data() + offset, memory.size() - offset, value);
+		EXPECT_NE(0, size);
+		EXPECT_EQ(expected, value);
+		offset += size;
+	}
+	EXPECT_EQ(brokenOffset, offset);
+	EXPECT_EQ(0, decodeVarint(memory.data() + offset, memory.size() - offset, value));
+	EXPECT_EQ(0, decodeVarint(memory.data() + offset + MAX_VARINT_SIZE, 2, value));
+
+	// the varints cross the borders of the chunks
+	for (size_t chunkSize = 1; chunkSize < 12; ++chunkSize) {
+		VirtualPointer<uint8_t> vMemory{};
+		for (offset = 0; offset < memory.size(); offset += chunkSize) {
+			vMemory.addChunk(memory.data() + offset, std::min(chunkSize, memory.size() - offset));
+		}
+		for (const uint64_t expected : values) {
+			EXPECT_TRUE(readVarint(vMemory, value));
+			EXPECT_EQ(expected, value);
+		}
+		EXPECT_EQ(memory.size() - brokenOffset, vMemory.bytesRemaining());
+		EXPECT_FALSE(readVarint(vMemory, value));
+		EXPECT_EQ(memory.size() - brokenOffset, vMemory.bytesRemaining());
+	}
+	EXPECT_EQ(-2, decodeZigzag(3));
+	EXPECT_EQ(2, decodeZigzag(4));
+}
+
+TEST(TestProtobufReader, IterateFields) {
+	// field 1 varint 150, field 2 string "testing", field 3 nested message { field 1 varint 1 }, field 4 fixed32, field 5 fixed64
+	std::vector<uint8_t> memory = { 0x08, 0x96, 0x01, 0x12, 0x07, 't', 'e', 's', 't', 'i', 'n', 'g', 0x1A, 0x02, 0x08, 0x01 };
+	memory.insert(memory.end(), { 0x25, 0x78, 0x56, 0x34, 0x12 });
+	memory.insert(memory.end(), { 0x29, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 });
+	encodeVarint(memory, (1000 << 3) | 0);
+	encodeVarint(memory, 0xFFFFFFFFFFFFFFFF);
+	VirtualPointer<uint8_t> message = splitIntoChunks(memory.data(), memory.size(), 4);
+
+	ProtobufReader reader(message, memory.size());
+	ProtobufField field;
+	EXPECT_TRUE(reader.next(field));
+	EXPECT_EQ(1, field.number);
+	EXPECT_EQ(WireType::VARINT, field.type);
+	EXPECT_EQ(150, field.value);
+	EXPECT_TRUE(reader.next(field));
+	EXPECT_EQ(2, field.number);
+	EXPECT_EQ(WireType::LENGTH_DELIMITED, field.type);
+	EXPECT_EQ(7, field.value);
+	EXPECT_EQ(0, memcmp(field.data, "testing", 7));
+	EXPECT_TRUE(reader.next(field));
+	EXPECT_EQ(3, field.number);
+	ProtobufReader nested(field.data, static_cast<size_t>(field.value));
+	ProtobufField nestedField;
+	EXPECT_TRUE(nested.next(nestedField));
+	EXPECT_EQ(1, nestedField.number);
+	EXPECT_EQ(1, nestedField.value);
+	EXPECT_FALSE(nested.next(nestedField));
+	EXPECT_FALSE(nested.hasError());
+	EXPECT_TRUE(reader.next(field));
+	EXPECT_EQ(WireType::FIXED32, field.type);
+	EXPECT_EQ(0x12345678, field.value);
+	EXPECT_TRUE(reader.next(field));
+	EXPECT_EQ(WireType::FIXED64, field.type);
+	EXPECT_EQ(0x0807060504030201u, field.value);
+	EXPECT_TRUE(reader.next(field));
+	EXPECT_EQ(1000, field.number);
+	EXPECT_EQ(0xFFFFFFFFFFFFFFFF, field.value);
+	EXPECT_FALSE(reader.next(field));
+	EXPECT_FALSE(reader.hasError());
+
+	// the length of the string is beyond the message
+	ProtobufReader broken(message + 3, 6);
+	EXPECT_FALSE(broken.next(field));
+	EXPECT_TRUE(broken.hasError());
+}
+
+TEST(TestBitstreamView, ReadBitsAtMatchesReader) {
+	// the sizes less than two machine words are read by BinaryReader in groups of other sizes
+	constexpr size_t maxSize = 40;
+	uint8_t memory[maxSize];
+	for (size_t i = 0; i < maxSize; ++i) {
+		memory[i] = static_cast<uint8_t>(i * 73 + 11);
+	}
+	const size_t counts[] = { 1, 7, 13, 32, 57, multiplyBy8(sizeof(size_t)) };
+	for (size_t size = 1; size <= maxSize; ++size) {
+		VirtualPointer<uint8_t> vMemory = splitIntoChunks(memory, size, 6);
+		for (const bool reverseBytes : { true, false }) {
+			for (const bool reverseBits : { true, false }) {
+				const BitstreamView<uint8_t> view(memory, size, reverseBytes, reverseBits);
+				const BitstreamView<uint8_t> virtualView(vMemory, size, reverseBytes, reverseBits);
+				EXPECT_EQ(8 * size, virtualView.getSizeInBits());
+				BinaryReader<uint8_t> reader(reverseBytes, reverseBits);
+				for (const size_t count : counts) {
+					for (size_t offset = 0; offset + count <= 8 * size; offset += count == 1 ? 1 : 3) {
+						size_t expected;
+						size_t value;
+						reader.setData(memory, size);
+						reader.skipBits(offset);
+						reader.readBits(count, expected);
+						EXPECT_TRUE(view.readBitsAt(offset, count, value));
+						EXPECT_EQ(expected, value) << size << " bytes, offset " << offset;
+						EXPECT_TRUE(virtualView.readBitsAt(offset, count, value));
+						EXPECT_EQ(expected, value) << size << " bytes, offset " << offset;
+					}
+				}
+				size_t value;
+				EXPECT_TRUE(view.readBitsAt(8 * size, 0, value));
+				EXPECT_FALSE(view.readBitsAt(8 * size - 3, 4, value));
+				EXPECT_FALSE(virtualView.readBitsAt(8 * size + 1, 0, value));
+			}
+		}
+		EXPECT_THROW(BitstreamView<uint8_t>(vMemory, size + 1), std::out_of_range);
+	}
+
+	constexpr size_t size = 37;
+	VirtualPointer<uint8_t> vMemory = splitIntoChunks(memory, size, 6);
+
+	// every element of wide virtual data gives its lowest byte as in BinaryReader
+	uint16_t wideMemory[size];
+	for (size_t i = 0; i < size; ++i) {
+		wideMemory[i] = static_cast<uint16_t>(0xA500 | memory[i]);
+	}
+	VirtualPointer<uint16_t> vWideMemory = splitIntoChunks(wideMemory, size, 5);
+	for (const bool reverseBytes : { true, false }) {
+		for (const bool reverseBits : { true, false }) {
+			const BitstreamView<uint16_t> wideView(vWideMemory, size, reverseBytes, reverseBits);
+			EXPECT_EQ(8 * size, wideView.getSizeInBits());
+			BinaryReader<uint16_t> reader(reverseBytes, reverseBits);
+			for (const size_t count : counts) {
+				for (size_t offset = 0; offset + count <= 8 * size; offset += 5) {
+					size_t expected;
+					size_t value;
+					reader.setData(vWideMemory, size);
+					reader.skipBits(offset);
+					reader.readBits(count, expected);
+					EXPECT_TRUE(wideView.readBitsAt(offset, count, value));
+					EXPECT_EQ(expected, value);
+				}
+			}
+		}
+	}
+	EXPECT_THROW(BitstreamView<uint16_t>(vWideMemory, size + 1), std::out_of_range);
+
+	// many threads read one view
+	const BitstreamView<uint8_t, ReversedBytes, DirectBits> view(vMemory, size);
+	std::vector<std::thread> threads;
+	std::vector<size_t> sums(4);
+	for (size_t thread = 0; thread < sums.size(); ++thread) {
+		threads.emplace_back([&view, &sums, thread]() {
+			size_t value;
+			for (size_t offset = 0; offset + 16 <= view.getSizeInBits(); ++offset) {
+				view.readBitsAt(offset, 16, value);
+				sums[thread] += value;
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	for (const size_t sum : sums) {
+		EXPECT_EQ(sums[0], sum);
+	}
+}
+
+TEST(TestBackwardBinaryReader, ReadsReversedData) {
+	// the backward reading of the data is the forward reading of the data with the reversed order of the bytes
+	constexpr size_t size = 77;
+	uint8_t memory[size];
+	uint8_t reversedMemory[size];
+	for (size_t i = 0; i < size; ++i) {
+		memory[i] = static_cast<uint8_t>(i * 151 + 7);
+		reversedMemory[size - 1 - i] = memory[i];
+	}
+	VirtualPointer<uint8_t> vMemory = splitIntoChunks(memory, size, 9);
+	for (const bool reverseBits : { true, false }) {
+		BinaryReader<uint8_t> expectedReader(REVERSE_BYTES, reverseBits);
+		BackwardBinaryReader<uint8_t> reader(reverseBits);
+		BackwardBinaryReader<uint8_t> virtualReader(reverseBits);
+		expectedReader.setData(reversedMemory, size);
+		reader.setData(memory, size);
+		virtualReader.setData(vMemory, size);
+		size_t expected;
+		size_t value;
+		for (size_t i = 0, count = 1; expectedReader.lookBits(count, expected); ++i, count = count * 5 % multiplyBy8(sizeof(size_t)) + 1) {
+			EXPECT_TRUE(reader.lookBits(count, value));
+			EXPECT_EQ(expected, value);
+			if (i % 4 == 3) {
+				EXPECT_TRUE(expectedReader.skipBits(count));
+				EXPECT_TRUE(reader.skipBits(count));
+				EXPECT_TRUE(virtualReader.skipBits(count));
+				continue;
+			}
+			EXPECT_TRUE(expectedReader.readBits(count, expected));
+			EXPECT_TRUE(reader.readBits(count, value));
+			EXPECT_EQ(expected, value);
+			EXPECT_TRUE(virtualReader.readBits(count, value));
+			EXPECT_EQ(expected, value);
+			EXPECT_EQ(reader.getRemainBitsCount(), virtualReader.getRemainBitsCount());
+		}
+		EXPECT_EQ(8 * size, reader.getReadBitsCount() + reader.getRemainBitsCount());
+		const auto remainBits = reader.getRemainBitsCount();
+		EXPECT_TRUE(reader.readBits(static_cast<size_t>(remainBits), value));
+		EXPECT_FALSE(reader.readBits(1, value));
+
+		// the long skip and the unchecked reading
+		expectedReader.setData(reversedMemory, size);
+		virtualReader.setData(vMemory, size);
+		EXPECT_TRUE(expectedReader.skipBits(8 * 50 + 3));
+		EXPECT_TRUE(virtualReader.skipBits(8 * 50 + 3));
+		virtualReader.refill();
+		EXPECT_LE(BackwardBinaryReader<uint8_t>::REFILLED_BITS, virtualReader.getCachedBitsCount());
+		EXPECT_TRUE(expectedReader.readBits(20, expected));
+		EXPECT_EQ(expected, virtualReader.readBitsUnchecked(20));
+		EXPECT_TRUE(expectedReader.readBits(30, expected));
+		EXPECT_EQ(expected, virtualReader.readBitsUnchecked(30));
+	}
+}
+
+TEST(TestBackwardBinaryReader, ReadsWideVirtualElements) {
+	constexpr size_t size = 45;
+	uint8_t memory[size];
+	uint16_t elements[size];
+	for (size_t i = 0; i < size; ++i) {
+		memory[i] = static_cast<uint8_t>(i * 151 + 7);
+		// the element gives its lowest byte, the highest one is not read
+		elements[i] = static_cast<uint16_t>(0x5A00 | memory[i]);
+	}
+	// chunks of three elements split every word
+	VirtualPointer<uint16_t> vElements{};
+	for (size_t offset = 0; offset < size; offset += 3) {
+		vElements.addChunk(elements + offset, std::min<size_t>(3, size - offset));
+	}
+
+	BackwardBinaryReader<uint8_t> reader{};
+	BackwardBinaryReader<uint16_t> virtualReader{};
+	reader.setData(memory, size);
+	virtualReader.setData(vElements, size);
+	size_t expected;
+	size_t value;
+	for (size_t count = 3; reader.lookBits(count, expected); count = count % 64 + 11) {
+		EXPECT_TRUE(virtualReader.lookBits(count, value));
+		EXPECT_EQ(expected, value);
+		EXPECT_TRUE(reader.readBits(count, expected));
+		EXPECT_TRUE(virtualReader.readBits(count, value));
+		EXPECT_EQ(expected, value);
+		// the skips over the next words
+		EXPECT_EQ(reader.skipBits(count * 2), virtualReader.skipBits(count * 2));
+		EXPECT_EQ(reader.getRemainBitsCount(), virtualReader.getRemainBitsCount());
+	}
+
+	reader.setData(memory, size);
+	virtualReader.setData(vElements, size);
+	reader.refill();
+	virtualReader.refill();
+	EXPECT_EQ(reader.readBitsUnchecked(50), virtualReader.readBitsUnchecked(50));
+}
+
+// encodes the symbols by the interleaved states to the stream read backward by FseTable::decode
+static size_t encodeFse(const int16_t* normalizedCounts, const size_t symbolsCount, const size_t tableLog,
+	const uint8_t* symbols, const size_t count, const size_t statesCount, uint8_t* memory, const size_t size) {
+	// the same spread of the symbols as the one of the table
+	const size_t tableSize = static_cast<size_t>(1) << tableLog;
+	std::vector<uint8_t> spread(tableSize);
+	size_t highThreshold = tableSize - 1;
+	for (size_t symbol = 0; symbol < symbolsCount; ++symbol) {
+		if (normalizedCounts[symbol] == -1) {
+			spread[highThreshold--] = static_cast<uint8_t>(symbol);
+		}
+	}
+	for (size_t symbol = 0, position = 0; symbol < symbolsCount; ++symbol) {
+		for (int16_t i = 0; i < normalizedCounts[symbol]; ++i) {
+			spread[position] = static_cast<uint8_t>(symbol);
+			do {
+				position = (position + (tableSize >> 1) + (tableSize >> 3) + 3) & (tableSize - 1);
+			} while (position > highThreshold);
+		}
+	}
+	std::vector<std::vector<size_t>> symbolStates(symbolsCount);
+	for (size_t state = 0; state < tableSize; ++state) {
+		symbolStates[spread[state]].push_back(state);
+	}
+	// the bits of the stream in the order of the reading: the initial states and the bits of the states after the symbols
+	std::vector<std::pair<size_t, size_t>> bits(count);
+	std::vector<size_t> states(statesCount);
+	for (size_t idx = count; idx--;) {
+		const std::vector<size_t>& nextStates = symbolStates[symbols[idx]];
+		size_t& state = states[idx % statesCount];
+		if (idx + statesCount >= count) {
+			state = nextStates[0] + tableSize;
+			continue;
+		}
+		size_t bitsCount = 0;
+		while ((state >> bitsCount) >= 2 * nextStates.size()) {
+			++bitsCount;
+		}
+		bits[idx + statesCount] = std::make_pair(bitsCount, state & LITTLE_BITS[bitsCount]);
+		state = nextStates[(state >> bitsCount) - nextStates.size()] + tableSize;
+	}
+	for (size_t i = 0; i < statesCount; ++i) {
+		bits[i] = std::make_pair(tableLog, states[i] - tableSize);
+	}
+	std::vector<uint8_t> stream(size);
+	BinaryWriter<uint8_t> writer(REVERSE_BYTES, !REVERSE_BITS);
+	writer.setData(stream.data(), size);
+	// the padding of zstd
+	writer.writeBits(4, 1);
+	size_t written = 4;
+	for (const auto& item : bits) {
+		writer.writeBits(item.first, item.second);
+		written += item.first;
+	}
+	writer.flush();
+	const size_t streamSize = divideBy8(written + 7);
+	std::reverse_copy(stream.begin(), stream.begin() + streamSize, memory);
+	return streamSize;
+}
+
+TEST(TestFseTable, DecodeInterleavedStates) {
+	const int16_t normalizedCounts[10] = { 20, 14, 10, 8, 5, 3, 1, -1, -1, 1 };
+	constexpr size_t tableLog = 6;
+	constexpr size_t count = 1001;
+	uint8_t symbols[count];
+	for (size_t i = 0; i < count; ++i) {
+		symbols[i] = static_cast<uint8_t>(i * i * 7 % 61 % 10);
+	}
+	const FseTable table(normalizedCounts, 10, tableLog);
+	EXPECT_EQ(tableLog, table.getTableLog());
+	uint8_t memory[1024];
+	VirtualPointer<uint8_t> vMemory = splitIntoChunks(memory, sizeof(memory), 13);
+	uint8_t decoded[count];
+	for (const size_t statesCount : { 1, 2, 4 }) {
+		const size_t size = encodeFse(normalizedCounts, 10, tableLog, symbols, count, statesCount, memory, sizeof(memory));
+		BackwardBinaryReader<uint8_t> reader{};
+		BackwardBinaryReader<uint8_t, DirectBits> virtualReader{};
+		reader.setData(memory, size);
+		virtualReader.setData(vMemory, size);
+		EXPECT_TRUE(FseTable::skipPadding(reader));
+		EXPECT_TRUE(FseTable::skipPadding(virtualReader));
+		for (int i = 0; i < 2; ++i) {
+			std::fill_n(decoded, count, 0xFF);
+			bool result;
+			switch (statesCount) {
+			case 1:
+				result = 0 == i ? table.decode<1>(reader, decoded, count) : table.decode<1>(virtualReader, decoded, count);
+				break;
+			case 2:
+				result = 0 == i ? table.decode<2>(reader, decoded, count) : table.decode<2>(virtualReader, decoded, count);
+				break;
+			default:
+				result = 0 == i ? table.decode<4>(reader, decoded, count) : table.decode<4>(virtualReader, decoded, count);
+				break;
+			}
+			EXPECT_TRUE(result);
+			EXPECT_TRUE(std::equal(symbols, symbols + count, decoded));
+		}
+		// only the padding of the writer is left
+		EXPECT_GT(8u, reader.getRemainBitsCount());
+		EXPECT_EQ(reader.getRemainBitsCount(), virtualReader.getRemainBitsCount());
+
+		// the truncated stream
+		reader.setData(memory + size / 2, size - size / 2);
+		EXPECT_TRUE(FseTable::skipPadding(reader));
+		EXPECT_FALSE(table.decode<2>(reader, decoded, count));
+	}
+
+	const int16_t wrongSum[3] = { 30, 20, 10 };
+	EXPECT_THROW(FseTable(wrongSum, 3, tableLog), std::invalid_argument);
+	EXPECT_THROW(FseTable(normalizedCounts, 10, 16), std::invalid_argument);
+	// the step of the spread is a multiple of the size of the smaller tables, so they are rejected
+	const int16_t smallCounts[2] = { 4, 4 };
+	EXPECT_THROW(FseTable(smallCounts, 2, 3), std::invalid_argument);
+	EXPECT_THROW(FseTable(smallCounts, 2, 1), std::invalid_argument);
+	const int16_t minimalCounts[2] = { 16, 16 };
+	EXPECT_NO_THROW(FseTable(minimalCounts, 2, FseTable::MIN_TABLE_LOG));
+}
+
+TEST(TestBinaryReader, StickyError) {
+	const uint8_t memory[] = { 0x47, 0x41, 0x00, 0x1A };
+	VirtualPointer<uint8_t> vMemory{};
+	vMemory.addChunk(const_cast<uint8_t*>(memory), 1);
+	vMemory.addChunk(const_cast<uint8_t*>(memory) + 1, sizeof(memory) - 1);
+
+	BinaryReader<uint8_t> rawReader{ REVERSE_BYTES };
+	BinaryReader<uint8_t> virtualReader{ REVERSE_BYTES };
+	rawReader.setData(memory, sizeof(memory));
+	virtualReader.setData(vMemory, sizeof(memory));
+	for (auto reader : { &rawReader, &virtualReader }) {
+		// the header of an MPEG-TS packet parsed by straight-line code
+		EXPECT_EQ(0x47, reader->readBits(8));
+		reader->skipBits(1);
+		EXPECT_EQ(0x1, reader->lookBits(1));
+		reader->skipBits(1);
+		EXPECT_EQ(0x100, reader->readBits(14));
+		EXPECT_EQ(0x1A, reader->readBits(8));
+		EXPECT_FALSE(reader->hasError());
+
+		// the data is over: the reading returns zeros and the flag stays set
+		const auto checkpoint = reader->mark();
+		EXPECT_EQ(0, reader->lookBits(1));
+		EXPECT_FALSE(reader->hasError());
+		EXPECT_EQ(0, reader->readBits(5));
+		EXPECT_TRUE(reader->hasError());
+		EXPECT_EQ(0, reader->readBits(0));
+		EXPECT_TRUE(reader->hasError());
+		reader->rewind(checkpoint);
+		EXPECT_FALSE(reader->hasError());
+
+		// the checked methods set the flag too
+		EXPECT_FALSE(reader->skipBits(1));
+		EXPECT_TRUE(reader->hasError());
+		reader->clearError();
+		EXPECT_FALSE(reader->hasError());
+		std::size_t value;
+		EXPECT_FALSE(reader->readBits(1, value));
+		EXPECT_TRUE(reader->hasError());
+	}
+	// the zero byte is not an Exp-Golomb code
+	rawReader.setData(memory + 2, 1);
+	EXPECT_FALSE(rawReader.hasError());
+	uint32_t value;
+	EXPECT_FALSE(rawReader.readUE(value));
+	EXPECT_TRUE(rawReader.hasError());
+}
+
+TEST(TestStreamBinaryReader, ReadsBlocksOfSources) {
+	constexpr size_t size = 5000;
+	std::vector<uint8_t> memory(size);
+	for (size_t i = 0; i < size; ++i) {
+		memory[i] = static_cast<uint8_t>(i * 73 + i / 256);
+	}
+	// the callback gives less bytes than asked as a socket does
+	size_t offset = 0;
+	CallbackByteSource callbackSource([&memory, &offset](uint8_t* buffer, const size_t sizeInBytes) {
+		const size_t count = std::min({ sizeInBytes, memory.size() - offset, offset % 37 + 1 });
+		std::memcpy(buffer, memory.data() + offset, count);
+		offset += count;
+		return count;
+	});
+	std::istringstream stream(std::string(memory.begin(), memory.end()));
+	StreamByteSource streamSource(stream);
+	for (ByteSource* source : { static_cast<ByteSource*>(&callbackSource), static_cast<ByteSource*>(&streamSource) }) {
+		StreamBinaryReader<> reader(*source, 100);
+		BinaryReader<uint8_t> expectedReader{ REVERSE_BYTES };
+		expectedReader.setData(memory.data(), size);
+		size_t expected;
+		size_t value;
+		for (size_t i = 0, count = 1; expectedReader.lookBits(count, expected); ++i, count = count * 7 % multiplyBy8(sizeof(size_t)) + 1) {
+			EXPECT_TRUE(reader.lookBits(count, value));
+			EXPECT_EQ(expected, value);
+			if (i % 50 == 49 && expectedReader.skipBits(8 * 150 + count)) {
+				// the skip over the blocks
+				EXPECT_TRUE(reader.skipBits(8 * 150 + count));
+			}
+			else {
+				EXPECT_TRUE(expectedReader.readBits(count, expected));
+				EXPECT_TRUE(reader.readBits(count, value));
+				EXPECT_EQ(expected, value);
+			}
+			EXPECT_EQ(expectedReader.getReadBitsCount(), reader.getReadBitsCount());
+		}
+		// the tail is read by the reader of the buffered bits
+		const auto tailSize = multiplyBy8(size) - reader.getReadBitsCount();
+		EXPECT_TRUE(reader.ensureBits(tailSize));
+		EXPECT_EQ(tailSize, reader.getBufferedBitsCount());
+		EXPECT_TRUE(reader.getReader().skipBits(tailSize));
+		EXPECT_FALSE(reader.readBits(1, value));
+		EXPECT_FALSE(reader.skipBits(1));
+		EXPECT_EQ(multiplyBy8(size), reader.getReadBitsCount());
+	}
+
+	// all the blocks are read by one thread of the reader
+	std::vector<std::thread::id> readingThreads;
+	CallbackByteSource countingSource([&readingThreads](uint8_t* buffer, const size_t sizeInBytes) {
+		readingThreads.push_back(std::this_thread::get_id());
+		const size_t count = readingThreads.size() <= 20 ? sizeInBytes : 0;
+		std::memset(buffer, 0, count);
+		return count;
+	});
+	{
+		StreamBinaryReader<> reader(countingSource, 10);
+		EXPECT_TRUE(reader.skipBits(8 * 10 * 20));
+		EXPECT_FALSE(reader.skipBits(1));
+	}
+	EXPECT_EQ(21, readingThreads.size());
+	EXPECT_NE(std::this_thread::get_id(), readingThreads.front());
+	EXPECT_EQ(readingThreads.size(), static_cast<size_t>(std::count(readingThreads.begin(), readingThreads.end(), readingThreads.front())));
+
+	size_t value;
+	// the source blocks as a socket without data till it is released or gives up
+	std::atomic<bool> released{ false };
+	std::atomic<size_t> startedReads{ 0 };
+	std::atomic<size_t> finishedReads{ 0 };
+	CallbackByteSource blockingSource([&released, &startedReads, &finishedReads](uint8_t* buffer, const size_t sizeInBytes) -> size_t {
+		if (!startedReads++) {
+			std::memset(buffer, 0, sizeInBytes);
+			++finishedReads;
+			return sizeInBytes;
+		}
+		for (size_t i = 0; i < 1000 && !released; ++i) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		++finishedReads;
+		return 0;
+	});
+	{
+		// the reader that is not read does not call the source
+		StreamBinaryReader<> reader(blockingSource, 100);
+	}
+	EXPECT_EQ(0, startedReads);
+	std::thread releasingThread;
+	{
+		// the destructor waits for the read of the second block requested by the first pull
+		StreamBinaryReader<> reader(blockingSource, 100);
+		EXPECT_TRUE(reader.readBits(8, value));
+		releasingThread = std::thread([&released]() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			released = true;
+		});
+	}
+	EXPECT_EQ(2, finishedReads);
+	releasingThread.join();
+	EXPECT_TRUE(released);
+
+	CallbackByteSource failingSource([](uint8_t*, size_t) -> size_t {
+		throw std::runtime_error("The connection is lost");
+	});
+	StreamBinaryReader<> reader(failingSource, 100);
+	EXPECT_THROW(reader.readBits(1, value), std::runtime_error);
+	EXPECT_FALSE(reader.readBits(1, value));
+	EXPECT_THROW(StreamBinaryReader<>(streamSource, 0), std::invalid_argument);
+}
+
+// the coroutine starting at once and destroyed with its task
+struct ParserTask final {
+	struct promise_type final {
+		ParserTask get_return_object() {
+			return ParserTask{ std::coroutine_handle<promise_type>::from_promise(*this) };
+		}
+		std::suspend_never initial_suspend() noexcept {
+			return {};
+		}
+		std::suspend_always final_suspend() noexcept {
+			return {};
+		}
+		void return_void() {
+		}
+		void unhandled_exception() {
+			std::terminate();
+		}
+	};
+
+	std::coroutine_handle<promise_type> handle;
+
+	~ParserTask() {
+		handle.destroy();
+	}
+};
+
+// reads the values of the counts, the counts of zero bits mean the skips of 100 bits and the reading of ue(v)
+static ParserTask parseAsync(AsyncBinaryReader<>& reader, const std::vector<size_t>& counts, std::vector<size_t>& values, bool& finished) {
+	for (const size_t count : counts) {
+		size_t value;
+		size_t lookedValue;
+		if (!count) {
+			EXPECT_TRUE(co_await reader.skipBits(100));
+			EXPECT_TRUE(co_await reader.ensureBits(multiplyBy8(sizeof(size_t))));
+			EXPECT_TRUE(reader.getReader().readUE(value));
+		}
+		else {
+			EXPECT_TRUE(co_await reader.lookBits(count, lookedValue));
+			EXPECT_TRUE(co_await reader.readBits(count, value));
+			EXPECT_EQ(lookedValue, value);
+		}
+		values.push_back(value);
+	}
+	// more than the whole data, so it waits for the end
+	EXPECT_FALSE(co_await reader.skipBits(std::numeric_limits<uint64_t>::max()));
+	finished = true;
+}
+
+TEST(TestAsyncBinaryReader, ResumesOnChunks) {
+	constexpr size_t size = 3000;
+	std::vector<uint8_t> memory(size);
+	for (size_t i = 0; i < size; ++i) {
+		memory[i] = static_cast<uint8_t>(i * 91 + i / 7);
+	}
+	BinaryReader<uint8_t> expectedReader{ REVERSE_BYTES };
+	expectedReader.setData(memory.data(), size);
+	std::vector<size_t> counts;
+	std::vector<size_t> expected;
+	for (size_t i = 0, count = 1; ; ++i, count = count * 5 % multiplyBy8(sizeof(size_t)) + 1) {
+		const auto checkpoint = expectedReader.mark();
+		size_t value;
+		const bool isSkip = i % 20 == 19;
+		if (isSkip ? !expectedReader.skipBits(100) || !expectedReader.readUE(value) : !expectedReader.readBits(count, value)) {
+			expectedReader.rewind(checkpoint);
+			break;
+		}
+		// the reading of ue(v) needs the word after the skip
+		if (isSkip && expectedReader.getReadBitsCount() + multiplyBy8(sizeof(size_t)) - 1 > multiplyBy8(size)) {
+			expectedReader.rewind(checkpoint);
+			break;
+		}
+		counts.push_back(isSkip ? 0 : count);
+		expected.push_back(value);
+	}
+
+	AsyncBinaryReader<> reader;
+	std::vector<size_t> values;
+	bool finished = false;
+	const ParserTask task = parseAsync(reader, counts, values, finished);
+	for (size_t offset = 0, length = 1; offset < size; offset += length, length = length % 13 + 1) {
+		EXPECT_FALSE(finished);
+		reader.addChunk(memory.data() + offset, std::min(length, size - offset));
+		// the chunks read through are dropped, only the chunks of the bits awaited by the parser are kept
+		EXPECT_GE(32u, reader.getBufferedChunksCount());
+	}
+	EXPECT_FALSE(finished);
+	EXPECT_EQ(expected, values);
+	EXPECT_EQ(expectedReader.getReadBitsCount(), reader.getReadBitsCount());
+	reader.finish();
+	EXPECT_TRUE(finished);
+	EXPECT_TRUE(task.handle.done());
+}
+
+// unpacks the values bit by bit taking the bits from the lowest bit of every byte
+static void unpackLsbFirst(const uint8_t* bytes, const size_t width, const size_t count, uint32_t* values) {
+	for (size_t i = 0; i < count; ++i) {
+		values[i] = 0;
+		for (size_t bit = 0; bit < width; ++bit) {
+			const size_t dataBit = i * width + bit;
+			values[i] |= static_cast<uint32_t>((bytes[divideBy8(dataBit)] >> (dataBit & 7)) & 1) << bit;
+		}
+	}
+}
+
+TEST(TestBinaryReader, ReadPackedArray) {
+	constexpr size_t size = 700;
+	constexpr size_t count = 150;
+	uint8_t memory[size];
+	for (size_t i = 0; i < size; ++i) {
+		memory[i] = static_cast<uint8_t>(i * 167 + i / 11);
+	}
+	VirtualPointer<uint8_t> vMemory = splitIntoChunks(memory, size, 17);
+	uint32_t values[count];
+	uint32_t expected[count];
+	for (size_t width = 1; width <= MAX_PACKED_WIDTH; ++width) {
+		for (const size_t offset : { 0, 3, 8 * 5, 8 * 9 + 7 }) {
+			// MSB_FIRST is the same as the reading of the values one by one
+			BinaryReader<uint8_t> expectedReader{ REVERSE_BYTES };
+			expectedReader.setData(memory, size);
+			expectedReader.skipBits(offset);
+			for (size_t i = 0; i < count; ++i) {
+				expectedReader.readBits(width, expected[i]);
+			}
+			size_t expectedNext;
+			expectedReader.readBits(8, expectedNext);
+
+			BinaryReader<uint8_t> rawReader{ REVERSE_BYTES };
+			BinaryReader<uint8_t, ReversedBytes, DirectBits> virtualReader{};
+			rawReader.setData(memory, size);
+			virtualReader.setData(vMemory, size);
+			rawReader.skipBits(offset);
+			virtualReader.skipBits(offset);
+			size_t next;
+			EXPECT_TRUE(rawReader.readPackedArray(width, count, values));
+			EXPECT_TRUE(std::equal(expected, expected + count, values));
+			EXPECT_TRUE(rawReader.readBits(8, next));
+			EXPECT_EQ(expectedNext, next);
+			EXPECT_TRUE(virtualReader.readPackedArray(width, count, values, BitPacking::MSB_FIRST));
+			EXPECT_TRUE(std::equal(expected, expected + count, values));
+			EXPECT_TRUE(virtualReader.readBits(8, next));
+			EXPECT_EQ(expectedNext, next);
+			if (offset & LITTLE_BITS[3]) {
+				EXPECT_FALSE(rawReader.readPackedArray(width, 1, values, BitPacking::LSB_FIRST));
+				continue;
+			}
+
+			// LSB_FIRST takes the bits of the bytes from the lowest one
+			unpackLsbFirst(memory + divideBy8(offset), width, count, expected);
+			rawReader.setData(memory, size);
+			virtualReader.setData(vMemory, size);
+			rawReader.skipBits(offset);
+			virtualReader.skipBits(offset);
+			EXPECT_TRUE(rawReader.readPackedArray(width, count, values, BitPacking::LSB_FIRST));
+			EXPECT_TRUE(std::equal(expected, expected + count, values));
+			EXPECT_EQ(offset + multiplyBy8(divideBy8(count * width + 7)), rawReader.getReadBitsCount());
+			EXPECT_TRUE(virtualReader.readPackedArray(width, count, values, BitPacking::LSB_FIRST));
+			EXPECT_TRUE(std::equal(expected, expected + count, values));
+			EXPECT_EQ(rawReader.getReadBitsCount(), virtualReader.getReadBitsCount());
+
+			// the bytes in other orders are read by groups of eight values
+			BinaryReader<uint8_t, DirectBytes, DirectBits> groupsReader{};
+			groupsReader.setData(memory, size);
+			uint8_t readBytes[size];
+			for (size_t i = 0; i < size; ++i) {
+				groupsReader.readBits(8, readBytes[i]);
+			}
+			unpackLsbFirst(readBytes + divideBy8(offset), width, count, expected);
+			groupsReader.setData(memory, size);
+			groupsReader.skipBits(offset);
+			EXPECT_TRUE(groupsReader.readPackedArray(width, count, values, BitPacking::LSB_FIRST));
+			EXPECT_TRUE(std::equal(expected, expected + count, values));
+			EXPECT_EQ(rawReader.getReadBitsCount(), groupsReader.getReadBitsCount());
+		}
+	}
+	BinaryReader<uint8_t> reader{ REVERSE_BYTES };
+	reader.setData(memory, size);
+	EXPECT_FALSE(reader.readPackedArray(0, 1, values));
+	EXPECT_FALSE(reader.readPackedArray(MAX_PACKED_WIDTH + 1, 1, values));
+	EXPECT_FALSE(reader.readPackedArray(8, size + 1, values));
+	EXPECT_EQ(0, reader.getReadBitsCount());
+	EXPECT_TRUE(reader.hasError());
+}
+
+// appends the runs of the RLE/bit-packing hybrid encoding, packedGroups[i] groups of eight values are packed
+// before the run of repeatedCounts[i] repeated values, the values are appended to expected
+static void encodeRleBitPacked(std::vector<uint8_t>& data, std::vector<uint32_t>& expected, const size_t bitWidth,
+	const std::vector<size_t>& packedGroups, const std::vector<size_t>& repeatedCounts) {
+	const uint32_t mask = static_cast<uint32_t>((static_cast<uint64_t>(1) << bitWidth) - 1);
+	for (size_t run = 0; run < packedGroups.size(); ++run) {
+		if (packedGroups[run]) {
+			encodeVarint(data, (packedGroups[run] << 1) | 1);
+			const size_t first = data.size();
+			data.resize(first + packedGroups[run] * bitWidth);
+			for (size_t i = 0; i < packedGroups[run] * 8; ++i) {
+				const uint32_t value = static_cast<uint32_t>((expected.size() + 1) * 2654435761u) & mask;
+				for (size_t bit = 0; bit < bitWidth; ++bit) {
+					data[first + divideBy8(i * bitWidth + bit)] |= static_cast<uint8_t>(((value >> bit) & 1) << ((i * bitWidth + bit) & 7));
+				}
+				expected.push_back(value);
+			}
+		}
+		if (repeatedCounts[run]) {
+			encodeVarint(data, repeatedCounts[run] << 1);
+			const uint32_t value = static_cast<uint32_t>(run * 0x9E3779B9u) & mask;
+			for (size_t i = 0; i < divideBy8(bitWidth + 7); ++i) {
+				data.push_back(static_cast<uint8_t>(value >> multiplyBy8(i)));
+			}
+			expected.insert(expected.end(), repeatedCounts[run], value);
+		}
+	}
+}
+
+TEST(TestBitUnpacking, VectorKernelsOnX86) {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	// the vector kernels are built for any target of x86 and every current x86 processor has SSE4.1,
+	// so ReadPackedArray tests the vector kernels
+	EXPECT_TRUE(hasVectorUnpacking());
+#else
+	EXPECT_FALSE(hasVectorUnpacking());
+#endif
+
+	// the widths over 25 bits are unpacked in 64-bit lanes, the groups of eight values are taken by the vector kernels
+	constexpr size_t size = 300;
+	constexpr size_t count = 64;
+	uint8_t memory[size];
+	for (size_t i = 0; i < size; ++i) {
+		memory[i] = static_cast<uint8_t>(i * 167 + i / 11);
+	}
+	uint32_t values[count];
+	for (size_t width = 26; width <= MAX_PACKED_WIDTH; ++width) {
+		for (size_t bitOffset = 0; bitOffset < 8; ++bitOffset) {
+			for (const BitPacking packing : { BitPacking::MSB_FIRST, BitPacking::LSB_FIRST }) {
+				unpackBits(memory, bitOffset, width, count, values, packing);
+				for (size_t i = 0; i < count; ++i) {
+					uint32_t expected = 0;
+					for (size_t bit = 0; bit < width; ++bit) {
+						const size_t dataBit = bitOffset + i * width + bit;
+						if (BitPacking::MSB_FIRST == packing) {
+							expected = (expected << 1) | ((memory[divideBy8(dataBit)] >> (7 - (dataBit & 7))) & 1);
+						}
+						else {
+							expected |= static_cast<uint32_t>((memory[divideBy8(dataBit)] >> (dataBit & 7)) & 1) << bit;
+						}
+					}
+					EXPECT_EQ(expected, values[i]) << width << " bits, offset " << bitOffset << ", value " << i;
+				}
+			}
+		}
+	}
+}
+
+TEST(TestRleBitPackedDecoder, DecodeRuns) {
+	using Reader = BinaryReader<uint8_t, ReversedBytes, DirectBits>;
+	const std::vector<size_t> packedGroups = { 1, 0, 5, 1, 40, 0, 3 };
+	const std::vector<size_t> repeatedCounts = { 3, 1000, 7, 0, 1, 20, 0 };
+	const size_t requests[] = { 1, 3, 8, 13, 64, 333 };
+	for (const size_t bitWidth : { 0, 1, 3, 8, 13, 17, 25, 32 }) {
+		std::vector<uint8_t> memory;
+		std::vector<uint32_t> expected;
+		encodeRleBitPacked(memory, expected, bitWidth, packedGroups, repeatedCounts);
+		VirtualPointer<uint8_t> vMemory = splitIntoChunks(memory.data(), memory.size(), 23);
+		for (const size_t request : requests) {
+			Reader rawReader{};
+			Reader virtualReader{};
+			rawReader.setData(memory.data(), memory.size());
+			virtualReader.setData(vMemory, memory.size());
+			RleBitPackedDecoder<uint8_t, ReversedBytes, DirectBits> rawDecoder(rawReader, bitWidth);
+			RleBitPackedDecoder<uint8_t, ReversedBytes, DirectBits> virtualDecoder(virtualReader, bitWidth);
+			std::vector<uint32_t> values(expected.size());
+			std::vector<uint32_t> virtualValues(expected.size());
+			for (size_t offset = 0; offset < expected.size(); offset += request) {
+				const size_t count = std::min(request, expected.size() - offset);
+				EXPECT_TRUE(rawDecoder.decode(values.data() + offset, count));
+				EXPECT_TRUE(virtualDecoder.decode(virtualValues.data() + offset, count));
+			}
+			EXPECT_EQ(expected, values);
+			EXPECT_EQ(expected, virtualValues);
+			EXPECT_EQ(multiplyBy8(memory.size()), rawReader.getReadBitsCount());
+			uint32_t value;
+			EXPECT_FALSE(rawDecoder.decode(&value, 1));
+		}
+	}
+
+	// the truncated data, the runs of no values, the repeated value wider than the bit width,
+	// the header longer than ten bytes and the header of ten bytes not fitting 64 bits followed by a valid run
+	std::vector<uint8_t> memory;
+	std::vector<uint32_t> expected;
+	encodeRleBitPacked(memory, expected, 5, { 2 }, { 0 });
+	memory.pop_back();
+	const std::vector<uint8_t> brokenRuns[] = { memory, { 0x00, 0x01 }, { 0x01 }, { 0x80, 0x00, 0x01 }, { 0x04, 0x20 },
+		{ 0x83, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00 },
+		{ 0x82, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x02, 0x01, 0x1E, 0x01 } };
+	for (const std::vector<uint8_t>& broken : brokenRuns) {
+		Reader reader{};
+		reader.setData(broken.data(), broken.size());
+		RleBitPackedDecoder<uint8_t, ReversedBytes, DirectBits> decoder(reader, 5);
+		uint32_t values[16];
+		EXPECT_FALSE(decoder.decode(values, 16));
+	}
+	Reader reader{};
+	EXPECT_THROW((RleBitPackedDecoder<uint8_t, ReversedBytes, DirectBits>(reader, MAX_PACKED_WIDTH + 1)), std::invalid_argument);
+}
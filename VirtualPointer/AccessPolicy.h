@@ -0,0 +1,22 @@
+#pragma once
+
+// Policies of the bounds handling of the VirtualPointer.
+// The checked policy validates the position and the state of the shared chunks
+// on every operation and throws an exception when the memory is over.
+// The unchecked policy is intended for the code that has already proven
+// the range to be valid: the checks are compiled out in release builds,
+// while debug builds keep them to catch the broken contract.
+
+struct CheckedAccess final
+{
+	static constexpr bool CHECK_BOUNDS = true;
+};
+
+struct UncheckedAccess final
+{
+#if defined(NDEBUG)
+	static constexpr bool CHECK_BOUNDS = false;
+#else
+	static constexpr bool CHECK_BOUNDS = true;
+#endif
+};
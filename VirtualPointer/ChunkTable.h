@@ -0,0 +1,697 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Tables of the chunks of the VirtualPointer.
+// A table keeps the beginning and the length (in elements) of every chunk
+// and must provide the same interface as VectorChunkTable.
+// A copy of a vector table shares the storage of the chunks with the original:
+// the chunks are appended in place while the storage ends at the last chunk of the table,
+// otherwise and before any other change the table copies its chunks to its own storage,
+// so the edits of the view (insert, erase, splice) take O(n). RopeChunkTable makes them O(log n).
+
+// Keeps a full pointer and a full length for every chunk.
+template <typename T>
+class VectorChunkTable final
+{
+public:
+	std::size_t size() const;
+	bool empty() const;
+
+	T* pointer(std::size_t idx) const;
+	std::size_t length(std::size_t idx) const;
+
+	// returns the total length of the chunks before idx, idx can be equal to size()
+	std::size_t offset(std::size_t idx) const;
+	// Returns the index of the chunk containing the element at offset and replaces offset by the offset in the chunk.
+	// Returns size() if offset is not less than the total length, offset is reduced by the total length then.
+	std::size_t find(std::size_t& offset) const;
+
+	void append(T* ptr, std::size_t length);
+	void insert(std::size_t idx, T* ptr, std::size_t length);
+	// inserts the chunks [first, src.size()) of another table before idx
+	void insert(std::size_t idx, const VectorChunkTable& src, std::size_t first);
+	// removes the chunks [first, last)
+	void erase(std::size_t first, std::size_t last);
+	void setLength(std::size_t idx, std::size_t length);
+
+private:
+	std::shared_ptr<std::vector<std::pair<T*, std::size_t>>> m_chunks = std::make_shared<std::vector<std::pair<T*, std::size_t>>>();
+	// the count of the chunks of this table, the shared storage can contain chunks appended by other copies
+	std::size_t m_size = 0;
+
+	// makes the storage owned by this table and ending at its last chunk
+	void detach();
+};
+
+// Keeps the chunks drawn from one base buffer: the base is the beginning of the first added chunk,
+// every chunk is stored as 32-bit offset from the base and 32-bit length in separate arrays.
+// The table takes half of the memory of VectorChunkTable and the traversal by lengths reads
+// only the array of lengths. A chunk that begins before the base, further than 2^32 elements
+// from it or is longer than 2^32 elements can not be added, std::out_of_range is thrown.
+template <typename T>
+class CompactChunkTable final
+{
+public:
+	std::size_t size() const;
+	bool empty() const;
+
+	T* pointer(std::size_t idx) const;
+	std::size_t length(std::size_t idx) const;
+
+	std::size_t offset(std::size_t idx) const;
+	std::size_t find(std::size_t& offset) const;
+
+	void append(T* ptr, std::size_t length);
+	void insert(std::size_t idx, T* ptr, std::size_t length);
+	void insert(std::size_t idx, const CompactChunkTable& src, std::size_t first);
+	// removes the chunks [first, last)
+	void erase(std::size_t first, std::size_t last);
+	void setLength(std::size_t idx, std::size_t length);
+
+private:
+	struct Storage final
+	{
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> lengths;
+	};
+
+	T* m_base = nullptr;
+	std::shared_ptr<Storage> m_chunks = std::make_shared<Storage>();
+	// the count of the chunks of this table, the shared storage can contain chunks appended by other copies
+	std::size_t m_size = 0;
+
+	// makes the storage owned by this table and ending at its last chunk
+	void detach();
+
+	uint32_t toOffset(T* ptr);
+	static uint32_t toOffset(const T* base, const T* ptr);
+	static uint32_t toLength(std::size_t length);
+};
+
+// Keeps the chunks in a persistent balanced (AVL) tree in the order of the chunks,
+// every node keeps the count and the total length of the chunks of its subtree.
+// The access to a chunk, the search of an offset, insert, erase and the insert of the chunks of another table
+// take O(log n), so do the edits of the view. A copy of the table takes O(1): the copies share the nodes,
+// which are never changed, and a change of a table creates only the nodes on its path.
+// The access to a chunk by its index is slower than in the vector tables,
+// so the table is intended for the views edited by insert, erase and splice.
+template <typename T>
+class RopeChunkTable final
+{
+public:
+	std::size_t size() const;
+	bool empty() const;
+
+	T* pointer(std::size_t idx) const;
+	std::size_t length(std::size_t idx) const;
+
+	std::size_t offset(std::size_t idx) const;
+	std::size_t find(std::size_t& offset) const;
+
+	void append(T* ptr, std::size_t length);
+	void insert(std::size_t idx, T* ptr, std::size_t length);
+	void insert(std::size_t idx, const RopeChunkTable& src, std::size_t first);
+	// removes the chunks [first, last)
+	void erase(std::size_t first, std::size_t last);
+	void setLength(std::size_t idx, std::size_t length);
+
+	// returns the height of the tree, the operations take O(height()) nodes, it is less than 1.44 * log2(size() + 2)
+	std::size_t height() const;
+
+private:
+	struct Node;
+	using NodePtr = std::shared_ptr<const Node>;
+
+	struct Node final
+	{
+		T* ptr;
+		std::size_t length;
+		NodePtr left;
+		NodePtr right;
+		// the count and the total length of the chunks of the subtree
+		std::size_t count;
+		std::size_t total;
+		std::size_t height;
+	};
+
+	NodePtr m_root;
+
+	const Node& node(std::size_t idx) const;
+
+	static std::size_t count(const NodePtr& node);
+	static std::size_t total(const NodePtr& node);
+	static std::size_t height(const NodePtr& node);
+	static NodePtr makeNode(const NodePtr& left, T* ptr, std::size_t length, const NodePtr& right);
+	static NodePtr rotateLeft(const NodePtr& node);
+	static NodePtr rotateRight(const NodePtr& node);
+	// joins the trees and the chunk between them, the trees can differ in height by any value
+	static NodePtr join(const NodePtr& left, T* ptr, std::size_t length, const NodePtr& right);
+	static NodePtr joinRight(const NodePtr& left, T* ptr, std::size_t length, const NodePtr& right);
+	static NodePtr joinLeft(const NodePtr& left, T* ptr, std::size_t length, const NodePtr& right);
+	// joins the trees without a chunk between them
+	static NodePtr concat(const NodePtr& left, const NodePtr& right);
+	// splits the tree into the first idx chunks and the rest
+	static std::pair<NodePtr, NodePtr> split(const NodePtr& node, std::size_t idx);
+	static NodePtr setLength(const NodePtr& node, std::size_t idx, std::size_t length);
+};
+
+
+template <typename T>
+inline std::size_t VectorChunkTable<T>::size() const
+{
+	return m_size;
+}
+
+template <typename T>
+inline bool VectorChunkTable<T>::empty() const
+{
+	return !m_size;
+}
+
+template <typename T>
+inline T* VectorChunkTable<T>::pointer(const std::size_t idx) const
+{
+	return (*m_chunks)[idx].first;
+}
+
+template <typename T>
+inline std::size_t VectorChunkTable<T>::length(const std::size_t idx) const
+{
+	return (*m_chunks)[idx].second;
+}
+
+template <typename T>
+std::size_t VectorChunkTable<T>::offset(const std::size_t idx) const
+{
+	std::size_t out = 0;
+	for (std::size_t i = 0; i < idx; ++i)
+	{
+		out += (*m_chunks)[i].second;
+	}
+	return out;
+}
+
+template <typename T>
+std::size_t VectorChunkTable<T>::find(std::size_t& offset) const
+{
+	std::size_t idx = 0;
+	for (; idx < m_size && offset >= (*m_chunks)[idx].second; ++idx)
+	{
+		offset -= (*m_chunks)[idx].second;
+	}
+	return idx;
+}
+
+template <typename T>
+void VectorChunkTable<T>::append(T* ptr, const std::size_t length)
+{
+	if (m_chunks->size() != m_size)
+	{
+		detach();
+	}
+	m_chunks->emplace_back(std::pair<T*, std::size_t>(ptr, length));
+	++m_size;
+}
+
+template <typename T>
+void VectorChunkTable<T>::insert(const std::size_t idx, T* ptr, const std::size_t length)
+{
+	detach();
+	m_chunks->emplace(m_chunks->begin() + idx, std::pair<T*, std::size_t>(ptr, length));
+	++m_size;
+}
+
+template <typename T>
+void VectorChunkTable<T>::insert(const std::size_t idx, const VectorChunkTable& src, const std::size_t first)
+{
+	detach();
+	m_chunks->insert(m_chunks->begin() + idx, src.m_chunks->cbegin() + first, src.m_chunks->cbegin() + src.m_size);
+	m_size += src.m_size - first;
+}
+
+template <typename T>
+void VectorChunkTable<T>::erase(const std::size_t first, const std::size_t last)
+{
+	detach();
+	m_chunks->erase(m_chunks->begin() + first, m_chunks->begin() + last);
+	m_size -= last - first;
+}
+
+template <typename T>
+void VectorChunkTable<T>::setLength(const std::size_t idx, const std::size_t length)
+{
+	detach();
+	(*m_chunks)[idx].second = length;
+}
+
+template <typename T>
+void VectorChunkTable<T>::detach()
+{
+	if (m_chunks.use_count() > 1)
+	{
+		m_chunks = std::make_shared<std::vector<std::pair<T*, std::size_t>>>(m_chunks->cbegin(), m_chunks->cbegin() + m_size);
+	}
+	else
+	{
+		m_chunks->resize(m_size);
+	}
+}
+
+
+template <typename T>
+inline std::size_t CompactChunkTable<T>::size() const
+{
+	return m_size;
+}
+
+template <typename T>
+inline bool CompactChunkTable<T>::empty() const
+{
+	return !m_size;
+}
+
+template <typename T>
+inline T* CompactChunkTable<T>::pointer(const std::size_t idx) const
+{
+	return m_base + m_chunks->offsets[idx];
+}
+
+template <typename T>
+inline std::size_t CompactChunkTable<T>::length(const std::size_t idx) const
+{
+	return m_chunks->lengths[idx];
+}
+
+template <typename T>
+std::size_t CompactChunkTable<T>::offset(const std::size_t idx) const
+{
+	std::size_t out = 0;
+	for (std::size_t i = 0; i < idx; ++i)
+	{
+		out += m_chunks->lengths[i];
+	}
+	return out;
+}
+
+template <typename T>
+std::size_t CompactChunkTable<T>::find(std::size_t& offset) const
+{
+	std::size_t idx = 0;
+	for (; idx < m_size && offset >= m_chunks->lengths[idx]; ++idx)
+	{
+		offset -= m_chunks->lengths[idx];
+	}
+	return idx;
+}
+
+template <typename T>
+void CompactChunkTable<T>::append(T* ptr, const std::size_t length)
+{
+	const uint32_t compactLength = toLength(length);
+	const uint32_t offset = toOffset(ptr);
+	if (m_chunks->lengths.size() != m_size)
+	{
+		detach();
+	}
+	m_chunks->offsets.push_back(offset);
+	m_chunks->lengths.push_back(compactLength);
+	++m_size;
+}
+
+template <typename T>
+void CompactChunkTable<T>::insert(const std::size_t idx, T* ptr, const std::size_t length)
+{
+	const uint32_t compactLength = toLength(length);
+	const uint32_t offset = toOffset(ptr);
+	detach();
+	m_chunks->offsets.insert(m_chunks->offsets.begin() + idx, offset);
+	m_chunks->lengths.insert(m_chunks->lengths.begin() + idx, compactLength);
+	++m_size;
+}
+
+template <typename T>
+void CompactChunkTable<T>::insert(const std::size_t idx, const CompactChunkTable& src, const std::size_t first)
+{
+	if (first == src.m_size)
+	{
+		return;
+	}
+	// the chunks are checked before the change, an empty table takes the base of the first inserted chunk
+	T* base = m_size ? m_base : src.pointer(first);
+	std::vector<uint32_t> offsets;
+	offsets.reserve(src.m_size - first);
+	for (std::size_t i = first; i < src.m_size; ++i)
+	{
+		offsets.push_back(toOffset(base, src.pointer(i)));
+	}
+	detach();
+	m_base = base;
+	m_chunks->offsets.insert(m_chunks->offsets.begin() + idx, offsets.cbegin(), offsets.cend());
+	m_chunks->lengths.insert(m_chunks->lengths.begin() + idx, src.m_chunks->lengths.cbegin() + first, src.m_chunks->lengths.cbegin() + src.m_size);
+	m_size += src.m_size - first;
+}
+
+template <typename T>
+void CompactChunkTable<T>::erase(const std::size_t first, const std::size_t last)
+{
+	detach();
+	m_chunks->offsets.erase(m_chunks->offsets.begin() + first, m_chunks->offsets.begin() + last);
+	m_chunks->lengths.erase(m_chunks->lengths.begin() + first, m_chunks->lengths.begin() + last);
+	m_size -= last - first;
+}
+
+template <typename T>
+void CompactChunkTable<T>::setLength(const std::size_t idx, const std::size_t length)
+{
+	const uint32_t compactLength = toLength(length);
+	detach();
+	m_chunks->lengths[idx] = compactLength;
+}
+
+template <typename T>
+void CompactChunkTable<T>::detach()
+{
+	if (m_chunks.use_count() > 1)
+	{
+		auto chunks = std::make_shared<Storage>();
+		chunks->offsets.assign(m_chunks->offsets.cbegin(), m_chunks->offsets.cbegin() + m_size);
+		chunks->lengths.assign(m_chunks->lengths.cbegin(), m_chunks->lengths.cbegin() + m_size);
+		m_chunks = std::move(chunks);
+	}
+	else
+	{
+		m_chunks->offsets.resize(m_size);
+		m_chunks->lengths.resize(m_size);
+	}
+}
+
+template <typename T>
+uint32_t CompactChunkTable<T>::toOffset(T* ptr)
+{
+	if (!m_size)
+	{
+		m_base = ptr;
+	}
+	return toOffset(m_base, ptr);
+}
+
+template <typename T>
+uint32_t CompactChunkTable<T>::toOffset(const T* basePtr, const T* ptr)
+{
+	const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+	const auto base = reinterpret_cast<std::uintptr_t>(basePtr);
+	if (address < base || (address - base) % sizeof(T) || (address - base) / sizeof(T) > std::numeric_limits<uint32_t>::max())
+	{
+		throw std::out_of_range("The chunk can not be represented by the compact chunk table");
+	}
+	return static_cast<uint32_t>((address - base) / sizeof(T));
+}
+
+template <typename T>
+uint32_t CompactChunkTable<T>::toLength(const std::size_t length)
+{
+	if (length > std::numeric_limits<uint32_t>::max())
+	{
+		throw std::out_of_range("The chunk can not be represented by the compact chunk table");
+	}
+	return static_cast<uint32_t>(length);
+}
+
+
+template <typename T>
+inline std::size_t RopeChunkTable<T>::size() const
+{
+	return count(m_root);
+}
+
+template <typename T>
+inline bool RopeChunkTable<T>::empty() const
+{
+	return !m_root;
+}
+
+template <typename T>
+inline T* RopeChunkTable<T>::pointer(const std::size_t idx) const
+{
+	return node(idx).ptr;
+}
+
+template <typename T>
+inline std::size_t RopeChunkTable<T>::length(const std::size_t idx) const
+{
+	return node(idx).length;
+}
+
+template <typename T>
+std::size_t RopeChunkTable<T>::offset(std::size_t idx) const
+{
+	std::size_t out = 0;
+	for (const Node* current = m_root.get(); nullptr != current;)
+	{
+		const std::size_t leftCount = count(current->left);
+		if (idx <= leftCount)
+		{
+			current = current->left.get();
+		}
+		else
+		{
+			out += total(current->left) + current->length;
+			idx -= leftCount + 1;
+			current = current->right.get();
+		}
+	}
+	return out;
+}
+
+template <typename T>
+std::size_t RopeChunkTable<T>::find(std::size_t& offset) const
+{
+	std::size_t idx = 0;
+	for (const Node* current = m_root.get(); nullptr != current;)
+	{
+		const std::size_t leftTotal = total(current->left);
+		if (offset < leftTotal)
+		{
+			current = current->left.get();
+			continue;
+		}
+		offset -= leftTotal;
+		idx += count(current->left);
+		if (offset < current->length)
+		{
+			return idx;
+		}
+		offset -= current->length;
+		++idx;
+		current = current->right.get();
+	}
+	return idx;
+}
+
+template <typename T>
+void RopeChunkTable<T>::append(T* ptr, const std::size_t length)
+{
+	m_root = join(m_root, ptr, length, nullptr);
+}
+
+template <typename T>
+void RopeChunkTable<T>::insert(const std::size_t idx, T* ptr, const std::size_t length)
+{
+	const auto parts = split(m_root, idx);
+	m_root = join(parts.first, ptr, length, parts.second);
+}
+
+template <typename T>
+void RopeChunkTable<T>::insert(const std::size_t idx, const RopeChunkTable& src, const std::size_t first)
+{
+	const auto parts = split(m_root, idx);
+	m_root = concat(concat(parts.first, split(src.m_root, first).second), parts.second);
+}
+
+template <typename T>
+void RopeChunkTable<T>::erase(const std::size_t first, const std::size_t last)
+{
+	const auto head = split(m_root, first);
+	m_root = concat(head.first, split(head.second, last - first).second);
+}
+
+template <typename T>
+void RopeChunkTable<T>::setLength(const std::size_t idx, const std::size_t length)
+{
+	m_root = setLength(m_root, idx, length);
+}
+
+template <typename T>
+inline std::size_t RopeChunkTable<T>::height() const
+{
+	return height(m_root);
+}
+
+template <typename T>
+const typename RopeChunkTable<T>::Node& RopeChunkTable<T>::node(std::size_t idx) const
+{
+	const Node* current = m_root.get();
+	while (true)
+	{
+		const std::size_t leftCount = count(current->left);
+		if (idx < leftCount)
+		{
+			current = current->left.get();
+		}
+		else if (idx == leftCount)
+		{
+			return *current;
+		}
+		else
+		{
+			idx -= leftCount + 1;
+			current = current->right.get();
+		}
+	}
+}
+
+template <typename T>
+inline std::size_t RopeChunkTable<T>::count(const NodePtr& node)
+{
+	return node ? node->count : 0;
+}
+
+template <typename T>
+inline std::size_t RopeChunkTable<T>::total(const NodePtr& node)
+{
+	return node ? node->total : 0;
+}
+
+template <typename T>
+inline std::size_t RopeChunkTable<T>::height(const NodePtr& node)
+{
+	return node ? node->height : 0;
+}
+
+template <typename T>
+typename RopeChunkTable<T>::NodePtr RopeChunkTable<T>::makeNode(const NodePtr& left, T* ptr, const std::size_t length, const NodePtr& right)
+{
+	return std::make_shared<const Node>(Node{ ptr, length, left, right,
+		count(left) + count(right) + 1, total(left) + total(right) + length, std::max(height(left), height(right)) + 1 });
+}
+
+template <typename T>
+typename RopeChunkTable<T>::NodePtr RopeChunkTable<T>::rotateLeft(const NodePtr& node)
+{
+	const Node& right = *node->right;
+	return makeNode(makeNode(node->left, node->ptr, node->length, right.left), right.ptr, right.length, right.right);
+}
+
+template <typename T>
+typename RopeChunkTable<T>::NodePtr RopeChunkTable<T>::rotateRight(const NodePtr& node)
+{
+	const Node& left = *node->left;
+	return makeNode(left.left, left.ptr, left.length, makeNode(left.right, node->ptr, node->length, node->right));
+}
+
+template <typename T>
+typename RopeChunkTable<T>::NodePtr RopeChunkTable<T>::join(const NodePtr& left, T* ptr, const std::size_t length, const NodePtr& right)
+{
+	if (height(left) > height(right) + 1)
+	{
+		return joinRight(left, ptr, length, right);
+	}
+	if (height(right) > height(left) + 1)
+	{
+		return joinLeft(left, ptr, length, right);
+	}
+	return makeNode(left, ptr, length, right);
+}
+
+template <typename T>
+typename RopeChunkTable<T>::NodePtr RopeChunkTable<T>::joinRight(const NodePtr& left, T* ptr, const std::size_t length, const NodePtr& right)
+{
+	// goes down the right spine of the higher left tree to the subtree of the height of the right tree
+	const Node& top = *left;
+	if (height(top.right) <= height(right) + 1)
+	{
+		const NodePtr joined = makeNode(top.right, ptr, length, right);
+		if (height(joined) <= height(top.left) + 1)
+		{
+			return makeNode(top.left, top.ptr, top.length, joined);
+		}
+		return rotateLeft(makeNode(top.left, top.ptr, top.length, rotateRight(joined)));
+	}
+	const NodePtr joined = joinRight(top.right, ptr, length, right);
+	const NodePtr out = makeNode(top.left, top.ptr, top.length, joined);
+	return height(joined) <= height(top.left) + 1 ? out : rotateLeft(out);
+}
+
+template <typename T>
+typename RopeChunkTable<T>::NodePtr RopeChunkTable<T>::joinLeft(const NodePtr& left, T* ptr, const std::size_t length, const NodePtr& right)
+{
+	const Node& top = *right;
+	if (height(top.left) <= height(left) + 1)
+	{
+		const NodePtr joined = makeNode(left, ptr, length, top.left);
+		if (height(joined) <= height(top.right) + 1)
+		{
+			return makeNode(joined, top.ptr, top.length, top.right);
+		}
+		return rotateRight(makeNode(rotateLeft(joined), top.ptr, top.length, top.right));
+	}
+	const NodePtr joined = joinLeft(left, ptr, length, top.left);
+	const NodePtr out = makeNode(joined, top.ptr, top.length, top.right);
+	return height(joined) <= height(top.right) + 1 ? out : rotateRight(out);
+}
+
+template <typename T>
+typename RopeChunkTable<T>::NodePtr RopeChunkTable<T>::concat(const NodePtr& left, const NodePtr& right)
+{
+	if (!left)
+	{
+		return right;
+	}
+	if (!right)
+	{
+		return left;
+	}
+	// the last chunk of the left tree joins the trees
+	const auto parts = split(left, left->count - 1);
+	return join(parts.first, parts.second->ptr, parts.second->length, right);
+}
+
+template <typename T>
+std::pair<typename RopeChunkTable<T>::NodePtr, typename RopeChunkTable<T>::NodePtr> RopeChunkTable<T>::split(const NodePtr& node, const std::size_t idx)
+{
+	if (!node)
+	{
+		return std::pair<NodePtr, NodePtr>();
+	}
+	const std::size_t leftCount = count(node->left);
+	if (idx <= leftCount)
+	{
+		const auto parts = split(node->left, idx);
+		return std::pair<NodePtr, NodePtr>(parts.first, join(parts.second, node->ptr, node->length, node->right));
+	}
+	const auto parts = split(node->right, idx - leftCount - 1);
+	return std::pair<NodePtr, NodePtr>(join(node->left, node->ptr, node->length, parts.first), parts.second);
+}
+
+template <typename T>
+typename RopeChunkTable<T>::NodePtr RopeChunkTable<T>::setLength(const NodePtr& node, const std::size_t idx, const std::size_t length)
+{
+	const std::size_t leftCount = count(node->left);
+	if (idx < leftCount)
+	{
+		return makeNode(setLength(node->left, idx, length), node->ptr, node->length, node->right);
+	}
+	if (idx == leftCount)
+	{
+		return makeNode(node->left, node->ptr, length, node->right);
+	}
+	return makeNode(node->left, node->ptr, node->length, setLength(node->right, idx - leftCount - 1, length));
+}
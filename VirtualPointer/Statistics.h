@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+
+// Counters of the hot paths of VirtualPointer and BinaryReader.
+// Counting is enabled by defining BINARY_VIRTUALIZATION_STATISTICS in the settings of every project of the program
+// (the Debug configurations of the solution do it), otherwise the counting functions are empty and are removed by the compiler.
+// The macro must not be defined in the sources: the translation units would compile different inline functions.
+// Counters are kept per thread, a snapshot and a reset affect only the calling thread.
+
+struct HotPathStatistics final
+{
+	// moves of a position from one chunk to another
+	uint64_t chunkCrossings = 0;
+	// bytes copied by the memory functions of VirtualPointer
+	uint64_t bytesCopied = 0;
+	// reloads of the BinaryReader cache
+	uint64_t cacheRefills = 0;
+	// shifts by an arbitrary count of elements or bits
+	uint64_t seeks = 0;
+	// chunks added to the chunk tables
+	uint64_t chunkTableGrowth = 0;
+	// calls of the index revalidation
+	uint64_t revalidations = 0;
+	// operations that could not be done by the fast path
+	uint64_t slowPaths = 0;
+};
+
+using statistic_counter_t = uint64_t HotPathStatistics::*;
+
+#if defined(BINARY_VIRTUALIZATION_STATISTICS)
+
+constexpr bool STATISTICS_ENABLED = true;
+
+inline HotPathStatistics& threadStatistics()
+{
+	thread_local HotPathStatistics statistics;
+	return statistics;
+}
+
+inline void countStatistic(const statistic_counter_t counter, const uint64_t value = 1)
+{
+	threadStatistics().*counter += value;
+}
+
+inline HotPathStatistics getStatisticsSnapshot()
+{
+	return threadStatistics();
+}
+
+inline void resetStatistics()
+{
+	threadStatistics() = HotPathStatistics();
+}
+
+#else
+
+constexpr bool STATISTICS_ENABLED = false;
+
+inline void countStatistic(statistic_counter_t, uint64_t = 1)
+{
+}
+
+inline HotPathStatistics getStatisticsSnapshot()
+{
+	return HotPathStatistics();
+}
+
+inline void resetStatistics()
+{
+}
+
+#endif
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "AccessPolicy.h"
+#include "ChunkTable.h"
 #include "Exceptions.h"
+#include "Statistics.h"
 
 #include <cstddef>
 #include <vector>
@@ -9,8 +12,9 @@
 #include <cstring>
 #include <functional>
 #include <stdexcept>
+#include <algorithm>
 
-template <typename T>
+template <typename T, typename AccessPolicy = CheckedAccess, typename ChunkTable = VectorChunkTable<T>>
 class VirtualPointer final
 {
 	using signed_size_t = std::ptrdiff_t;
@@ -42,48 +46,83 @@ public:
 	void addChunk(T* ptr, std::size_t length);
 	void addChunk(const VirtualPointer& src, std::size_t count);
 
+	// Edits of the view, positions are counted in elements from the current position.
+	// Only the chunk table is changed, the memory of the chunks is never copied.
+	// After an edit the pointer owns its own chunk table,
+	// so the copies made before the edit keep the previous view.
+	// Every edit copies the chunk table: with the default VectorChunkTable (and CompactChunkTable)
+	// an edit takes O(n) in the count of the chunks, only RopeChunkTable makes it O(log n).
+	void insert(std::size_t pos, T* ptr, std::size_t length);
+	void erase(std::size_t pos, std::size_t count);
+	// inserts all the remaining elements of src
+	void splice(std::size_t pos, const VirtualPointer& src);
+
 	std::size_t bytesRemaining() const;
 
+	// Returns the address of the current element and writes to count the number of elements
+	// from it to the end of its chunk. Returns nullptr and writes zero if the current position is out of range.
+	T* contiguousData(std::size_t& count) const;
+
 	void clear();
 
+	// Returns a copy with its own chunk table. The table shares the chunks with the table of this pointer
+	// and is copied only when one of them is changed not by appending at its end,
+	// so chunks added to the fork are not seen by this pointer and vice versa.
+	VirtualPointer fork() const;
+
+	// The current position of the pointer. It can be restored in O(1) without walking the chunks,
+	// but only by the pointer that shares the chunk table with the one the position was taken from
+	// and only while the chunks before the position are not edited.
+	struct Position final
+	{
+		T* pCurrentChunk;
+		std::size_t curChunkIdx;
+		signed_size_t curTIdx;
+		std::size_t curChunkSize;
+		std::size_t bytesRemaining;
+		std::size_t endVectorIndex;
+	};
+	Position getPosition() const;
+	void setPosition(const Position& position);
+
 	bool isOverflow() const;
 
-	template<typename T, typename V>
-	friend VirtualPointer<T>& memset(VirtualPointer<T>& dest, const V& value, std::size_t count);
+	template<typename U, typename P, typename C, typename V>
+	friend VirtualPointer<U, P, C>& memset(VirtualPointer<U, P, C>& dest, const V& value, std::size_t count);
 
-	template<typename T>
-	friend VirtualPointer<T>& memcpy(VirtualPointer<T>& dest, const VirtualPointer<T>& src, std::size_t count);
+	template<typename U, typename P, typename C>
+	friend VirtualPointer<U, P, C>& memcpy(VirtualPointer<U, P, C>& dest, const VirtualPointer<U, P, C>& src, std::size_t count);
 
-	template<typename T>
-	friend VirtualPointer<T>& memcpy(VirtualPointer<T>& dest, const void* src, std::size_t count);
+	template<typename U, typename P, typename C>
+	friend VirtualPointer<U, P, C>& memcpy(VirtualPointer<U, P, C>& dest, const void* src, std::size_t count);
 
-	template<typename T>
-	friend void* memcpy(void* dest, const VirtualPointer<T>& src, std::size_t count);
+	template<typename U, typename P, typename C>
+	friend void* memcpy(void* dest, const VirtualPointer<U, P, C>& src, std::size_t count);
 
 
 	// Attention! All memmove functions can allocate an additional amount of memory of the count bytesRemaining!
-	template<typename T>
-	friend VirtualPointer<T>& memmove(VirtualPointer<T>& dest, const VirtualPointer<T>& src, std::size_t count);
+	template<typename U, typename P, typename C>
+	friend VirtualPointer<U, P, C>& memmove(VirtualPointer<U, P, C>& dest, const VirtualPointer<U, P, C>& src, std::size_t count);
 
-	template<typename T>
-	friend VirtualPointer<T>& memmove(VirtualPointer<T>& dest, const void* src, std::size_t count);
+	template<typename U, typename P, typename C>
+	friend VirtualPointer<U, P, C>& memmove(VirtualPointer<U, P, C>& dest, const void* src, std::size_t count);
 
-	template<typename T>
-	friend void* memmove(void* dest, const VirtualPointer<T>& src, std::size_t count);
+	template<typename U, typename P, typename C>
+	friend void* memmove(void* dest, const VirtualPointer<U, P, C>& src, std::size_t count);
 
 
-	template<typename T>
-	friend int memcmp(const VirtualPointer<T>& dest, const VirtualPointer<T>& src, std::size_t count);
+	template<typename U, typename P, typename C>
+	friend int memcmp(const VirtualPointer<U, P, C>& dest, const VirtualPointer<U, P, C>& src, std::size_t count);
 
-	template<typename T>
-	friend int memcmp(const VirtualPointer<T>& dest, const void* src, std::size_t count);
+	template<typename U, typename P, typename C>
+	friend int memcmp(const VirtualPointer<U, P, C>& dest, const void* src, std::size_t count);
 
-	template<typename T>
-	friend int memcmp(const void* dest, const VirtualPointer<T>& src, std::size_t count);
+	template<typename U, typename P, typename C>
+	friend int memcmp(const void* dest, const VirtualPointer<U, P, C>& src, std::size_t count);
 
 private:
 	// contains all chunks with their sizes
-	std::shared_ptr<std::vector<std::pair<T*, std::size_t>>> m_chunks;
+	std::shared_ptr<ChunkTable> m_chunks;
 	T* m_pCurrentChunk = nullptr;
 	// contains the index of a current chunk in chunks collection
 	std::size_t m_curChunkIdx = 0;
@@ -117,47 +156,58 @@ private:
 	void validateBytesRemaining() const; 
 	void increaseBytesRemaining(std::size_t value);
 	void decreaseBytesRemaining(std::size_t value);
+
+	// returns the offset of the current position from the beginning of the first chunk
+	signed_size_t absolutePosition() const;
+	// checks that [pos, pos + count) is inside the memory and returns the offset of pos from the beginning
+	std::size_t editOffset(std::size_t pos, std::size_t count) const;
+	// splits the chunk containing the offset, returns the index of the chunk beginning at the offset
+	static std::size_t splitChunk(ChunkTable& chunks, std::size_t offset);
+	// sets the edited chunks and moves the current position to the same offset
+	void replaceChunks(std::shared_ptr<ChunkTable> chunks, signed_size_t position);
 };
 
-template <typename T>
-VirtualPointer<T> operator+(VirtualPointer<T> ptr, const std::size_t& shift);
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable> operator+(VirtualPointer<T, AccessPolicy, ChunkTable> ptr, const std::size_t& shift);
 
-template <typename T>
-VirtualPointer<T> operator+(const std::size_t& shift, VirtualPointer<T> ptr);
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable> operator+(const std::size_t& shift, VirtualPointer<T, AccessPolicy, ChunkTable> ptr);
 
-template <typename T>
-VirtualPointer<T> operator-(VirtualPointer<T> ptr, const std::size_t& shift);
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable> operator-(VirtualPointer<T, AccessPolicy, ChunkTable> ptr, const std::size_t& shift);
 
 
-template <typename T>
-bool VirtualPointer<T>::outOfRange() const
+template <typename T, typename AccessPolicy, typename ChunkTable>
+bool VirtualPointer<T, AccessPolicy, ChunkTable>::outOfRange() const
 {
 	return m_chunks->empty() || (m_curChunkIdx + 1 == m_chunks->size() && static_cast<size_t>(m_curTIdx) >= m_curChunkSize);
 }
 
 
-template <typename T>
-void VirtualPointer<T>::revalidateIndexes()
+template <typename T, typename AccessPolicy, typename ChunkTable>
+void VirtualPointer<T, AccessPolicy, ChunkTable>::revalidateIndexes()
 {
+	countStatistic(&HotPathStatistics::revalidations);
 	if(!m_pCurrentChunk && !m_chunks->empty())
 	{
-		m_pCurrentChunk = (*m_chunks)[m_curChunkIdx].first;
+		m_pCurrentChunk = m_chunks->pointer(m_curChunkIdx);
 	}
 	if (!m_curChunkSize && m_curChunkIdx < m_chunks->size())
 	{
-		m_curChunkSize = (*m_chunks)[m_curChunkIdx].second;
+		m_curChunkSize = m_chunks->length(m_curChunkIdx);
 	}
 	while (m_curChunkIdx < m_chunks->size() - 1 && static_cast<size_t>(m_curTIdx) >= m_curChunkSize)
 	{
 		m_curTIdx -= m_curChunkSize;
 		++m_curChunkIdx;
-		m_pCurrentChunk = (*m_chunks)[m_curChunkIdx].first;
-		m_curChunkSize = (*m_chunks)[m_curChunkIdx].second;
+		m_pCurrentChunk = m_chunks->pointer(m_curChunkIdx);
+		m_curChunkSize = m_chunks->length(m_curChunkIdx);
+		countStatistic(&HotPathStatistics::chunkCrossings);
 	}
 }
 
-template <typename T>
-void VirtualPointer<T>::validateBytesRemaining() const
+template <typename T, typename AccessPolicy, typename ChunkTable>
+void VirtualPointer<T, AccessPolicy, ChunkTable>::validateBytesRemaining() const
 {
 	if(m_endVectorIndex == m_chunks->size())
 	{
@@ -165,27 +215,33 @@ void VirtualPointer<T>::validateBytesRemaining() const
 	}
 	for (auto i = m_endVectorIndex; i < m_chunks->size(); ++i)
 	{
-		m_bytesRemaining += (*m_chunks)[i].second * sizeof(T);
+		m_bytesRemaining += m_chunks->length(i) * sizeof(T);
 	}
 	m_endVectorIndex = m_chunks->size();
 }
 
-template <typename T>
-void VirtualPointer<T>::increaseBytesRemaining(const std::size_t value)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+void VirtualPointer<T, AccessPolicy, ChunkTable>::increaseBytesRemaining(const std::size_t value)
 {
-	validateBytesRemaining();
+	if (AccessPolicy::CHECK_BOUNDS)
+	{
+		validateBytesRemaining();
+	}
 	m_bytesRemaining += value;
 }
 
-template <typename T>
-void VirtualPointer<T>::decreaseBytesRemaining(const std::size_t value)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+void VirtualPointer<T, AccessPolicy, ChunkTable>::decreaseBytesRemaining(const std::size_t value)
 {
-	validateBytesRemaining();
+	if (AccessPolicy::CHECK_BOUNDS)
+	{
+		validateBytesRemaining();
+	}
 	m_bytesRemaining -= value;
 }
 
-template <typename T>
-bool VirtualPointer<T>::outOfRangeWithRevalidateIndexes()
+template <typename T, typename AccessPolicy, typename ChunkTable>
+bool VirtualPointer<T, AccessPolicy, ChunkTable>::outOfRangeWithRevalidateIndexes()
 {
 	if (m_chunks->empty())
 	{
@@ -201,14 +257,14 @@ T min(T f, T s)
 	return f < s ? f : s;
 }
 
-template <typename T>
-VirtualPointer<T>::VirtualPointer() :
-	m_chunks(std::make_shared<std::vector<std::pair<T*, std::size_t>>>())
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable>::VirtualPointer() :
+	m_chunks(std::make_shared<ChunkTable>())
 {
 }
 
-template <typename T>
-VirtualPointer<T>::VirtualPointer(const VirtualPointer& other) :
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable>::VirtualPointer(const VirtualPointer& other) :
 	m_chunks(other.m_chunks),
 	m_pCurrentChunk(other.m_pCurrentChunk),
 	m_curChunkIdx(other.m_curChunkIdx),
@@ -219,8 +275,8 @@ VirtualPointer<T>::VirtualPointer(const VirtualPointer& other) :
 {
 }
 
-template <typename T>
-VirtualPointer<T>::VirtualPointer(VirtualPointer&& other) noexcept :
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable>::VirtualPointer(VirtualPointer&& other) noexcept :
 	m_chunks(std::move(other.m_chunks))
 {
 	m_pCurrentChunk = other.m_pCurrentChunk;
@@ -231,26 +287,27 @@ VirtualPointer<T>::VirtualPointer(VirtualPointer&& other) noexcept :
 	m_endVectorIndex = other.m_endVectorIndex;
 }
 
-template <typename T>
-VirtualPointer<T>& VirtualPointer<T>::operator++()
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable>& VirtualPointer<T, AccessPolicy, ChunkTable>::operator++()
 {
 	toNextElement();
 	return *this;
 }
 
-template <typename T>
-VirtualPointer<T> VirtualPointer<T>::operator++(int)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable> VirtualPointer<T, AccessPolicy, ChunkTable>::operator++(int)
 {
-	VirtualPointer<T> out = VirtualPointer<T>(*this);
+	VirtualPointer out = VirtualPointer(*this);
 	toNextElement();
 	return out;
 }
 
-template <typename T>
-VirtualPointer<T>& VirtualPointer<T>::operator+=(const std::size_t shift)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable>& VirtualPointer<T, AccessPolicy, ChunkTable>::operator+=(const std::size_t shift)
 {
 	std::size_t localShift = shift;
 	decreaseBytesRemaining(shift * sizeof(T));
+	countStatistic(&HotPathStatistics::seeks);
 	if (m_curTIdx + localShift >= m_curChunkSize)
 	{
 		if (m_curChunkIdx + 1 >= m_chunks->size())
@@ -261,39 +318,49 @@ VirtualPointer<T>& VirtualPointer<T>::operator+=(const std::size_t shift)
 		localShift -= m_curChunkSize - m_curTIdx;
 		m_curTIdx = 0;
 		++m_curChunkIdx;
-		auto chunk = m_chunks->cbegin() + m_curChunkIdx;
-		m_curChunkSize = chunk->second;
+		std::size_t chunk = m_curChunkIdx;
+		m_curChunkSize = m_chunks->length(chunk);
 		++chunk;
-		for (; chunk != m_chunks->cend() && localShift >= m_curChunkSize; ++chunk)
+		for (; chunk != m_chunks->size() && localShift >= m_curChunkSize; ++chunk)
 		{
 			localShift -= m_curChunkSize;
-			m_curChunkSize = chunk->second;
+			m_curChunkSize = m_chunks->length(chunk);
 		}
-		m_curChunkIdx = chunk - m_chunks->cbegin() - 1;
-		m_pCurrentChunk = (*m_chunks)[m_curChunkIdx].first;
+		const std::size_t curChunkIdx = chunk - 1;
+		countStatistic(&HotPathStatistics::chunkCrossings, curChunkIdx - m_curChunkIdx + 1);
+		m_curChunkIdx = curChunkIdx;
+		m_pCurrentChunk = m_chunks->pointer(m_curChunkIdx);
 	}
 	m_curTIdx += localShift;
 	return *this;
 }
 
-template <typename T, typename V>
-VirtualPointer<T>& memset(VirtualPointer<T>& dest, const V& value, std::size_t count)
+template <typename T, typename AccessPolicy, typename ChunkTable, typename V>
+VirtualPointer<T, AccessPolicy, ChunkTable>& memset(VirtualPointer<T, AccessPolicy, ChunkTable>& dest, const V& value, std::size_t count)
 {
 	// need to be done because if not to do and the count is zero, then the next checks will fall with underflow
 	if (!count)
 	{
 		return dest;
 	}
-	if (dest.m_chunks->empty())
+	if (AccessPolicy::CHECK_BOUNDS)
 	{
-		throw NullPointerException();
+		if (dest.m_chunks->empty())
+		{
+			throw NullPointerException();
+		}
+		if (dest.outOfRangeWithRevalidateIndexes())
+		{
+			throw std::out_of_range("Attempt to go abroad the memory");
+		}
 	}
-	if (dest.outOfRangeWithRevalidateIndexes())
+	else
 	{
-		throw std::out_of_range("Attempt to go abroad the memory");
+		// the chunks added by the copies are not seen by the cached size of the current chunk
+		dest.revalidateIndexes();
 	}
-	auto chunk = dest.m_chunks->begin() + dest.m_curChunkIdx;
-	T* ptr = chunk->first + dest.m_curTIdx;
+	std::size_t chunk = dest.m_curChunkIdx;
+	T* ptr = dest.m_chunks->pointer(chunk) + dest.m_curTIdx;
 	for (std::size_t i = dest.m_curTIdx; i < dest.m_curChunkSize; ++i)
 	{
 		*ptr = static_cast<T>(value);
@@ -304,10 +371,10 @@ VirtualPointer<T>& memset(VirtualPointer<T>& dest, const V& value, std::size_t c
 		--count;
 		++ptr;
 	}
-	for (++chunk; chunk < dest.m_chunks->end() - 1; ++chunk)
+	for (++chunk; chunk + 1 < dest.m_chunks->size(); ++chunk)
 	{
-		ptr = chunk->first;
-		for (std::size_t i = 0; i < chunk->second; ++i)
+		ptr = dest.m_chunks->pointer(chunk);
+		for (std::size_t i = 0; i < dest.m_chunks->length(chunk); ++i)
 		{
 			*(ptr) = static_cast<T>(value);
 			if (!(count - 1))
@@ -318,12 +385,12 @@ VirtualPointer<T>& memset(VirtualPointer<T>& dest, const V& value, std::size_t c
 			++ptr;
 		}
 	}
-	if (chunk >= dest.m_chunks->end())
+	if (chunk >= dest.m_chunks->size())
 	{
 		throw std::out_of_range("Attempt to go abroad the memory");
 	}
-	ptr = chunk->first;
-	for (std::size_t i = 0; i < chunk->second; ++i)
+	ptr = dest.m_chunks->pointer(chunk);
+	for (std::size_t i = 0; i < dest.m_chunks->length(chunk); ++i)
 	{
 		*(ptr) = static_cast<T>(value);
 		if (!(count - 1))
@@ -336,21 +403,30 @@ VirtualPointer<T>& memset(VirtualPointer<T>& dest, const V& value, std::size_t c
 	throw std::out_of_range("Attempt to go abroad the memory");
 }
 
-template <typename T>
-VirtualPointer<T>& memcpy(VirtualPointer<T>& dest, const VirtualPointer<T>& src, std::size_t count)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable>& memcpy(VirtualPointer<T, AccessPolicy, ChunkTable>& dest, const VirtualPointer<T, AccessPolicy, ChunkTable>& src, std::size_t count)
 {
 	if (!count)
 	{
 		return dest;
 	}
-	if (src.m_chunks->empty() || dest.m_chunks->empty())
+	if (AccessPolicy::CHECK_BOUNDS)
 	{
-		throw NullPointerException();
+		if (src.m_chunks->empty() || dest.m_chunks->empty())
+		{
+			throw NullPointerException();
+		}
+		if (dest.outOfRangeWithRevalidateIndexes() || src.outOfRange())
+		{
+			throw std::out_of_range("Attempt to go abroad the memory");
+		}
 	}
-	if (dest.outOfRangeWithRevalidateIndexes() || src.outOfRange())
+	else
 	{
-		throw std::out_of_range("Attempt to go abroad the memory");
+		// the chunks added by the copies are not seen by the cached size of the current chunk
+		dest.revalidateIndexes();
 	}
+	countStatistic(&HotPathStatistics::bytesCopied, count * sizeof(T));
 	std::size_t curChunkIdx = dest.m_curChunkIdx;
 
 	std::size_t curSrcChunkIdx = src.m_curChunkIdx;
@@ -358,8 +434,8 @@ VirtualPointer<T>& memcpy(VirtualPointer<T>& dest, const VirtualPointer<T>& src,
 	std::size_t blockMemLeft = dest.m_curChunkSize - dest.m_curTIdx;
 	std::size_t srcBlockMemLeft = src.m_curChunkSize - src.m_curTIdx;
 
-	T* destPtr = (*(dest.m_chunks))[curChunkIdx].first + dest.m_curTIdx;
-	const T* srcPtr = (*(src.m_chunks))[curSrcChunkIdx].first + src.m_curTIdx;
+	T* destPtr = dest.m_chunks->pointer(curChunkIdx) + dest.m_curTIdx;
+	const T* srcPtr = src.m_chunks->pointer(curSrcChunkIdx) + src.m_curTIdx;
 
 	auto memoryOver = false;
 
@@ -383,52 +459,61 @@ VirtualPointer<T>& memcpy(VirtualPointer<T>& dest, const VirtualPointer<T>& src,
 		if (!blockMemLeft)
 		{
 			++curChunkIdx;
-			if (dest.m_chunks->size() <= curChunkIdx)
+			if (AccessPolicy::CHECK_BOUNDS && dest.m_chunks->size() <= curChunkIdx)
 			{
 				memoryOver = true;
 			}
 			else
 			{
-				destPtr = (*(dest.m_chunks))[curChunkIdx].first;
-				blockMemLeft = (*(dest.m_chunks))[curChunkIdx].second;
+				destPtr = dest.m_chunks->pointer(curChunkIdx);
+				blockMemLeft = dest.m_chunks->length(curChunkIdx);
 			}
 		}
 		if (!srcBlockMemLeft)
 		{
 			++curSrcChunkIdx;
-			if (src.m_chunks->size() <= curSrcChunkIdx)
+			if (AccessPolicy::CHECK_BOUNDS && src.m_chunks->size() <= curSrcChunkIdx)
 			{
 				memoryOver = true;
 			}
 			else
 			{
-				srcPtr = (*(src.m_chunks))[curSrcChunkIdx].first;
-				srcBlockMemLeft = (*(src.m_chunks))[curSrcChunkIdx].second;
+				srcPtr = src.m_chunks->pointer(curSrcChunkIdx);
+				srcBlockMemLeft = src.m_chunks->length(curSrcChunkIdx);
 			}
 		}
 	}
 }
 
-template <typename T>
-VirtualPointer<T>& memcpy(VirtualPointer<T>& dest, const void* src, std::size_t count)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable>& memcpy(VirtualPointer<T, AccessPolicy, ChunkTable>& dest, const void* src, std::size_t count)
 {
 	if (!count)
 	{
 		return dest;
 	}
-	if (!src || dest.m_chunks->empty())
+	if (AccessPolicy::CHECK_BOUNDS)
 	{
-		throw NullPointerException();
+		if (!src || dest.m_chunks->empty())
+		{
+			throw NullPointerException();
+		}
+		if (dest.outOfRangeWithRevalidateIndexes())
+		{
+			throw std::out_of_range("Attempt to go abroad the memory");
+		}
 	}
-	if (dest.outOfRangeWithRevalidateIndexes())
+	else
 	{
-		throw std::out_of_range("Attempt to go abroad the memory");
+		// the chunks added by the copies are not seen by the cached size of the current chunk
+		dest.revalidateIndexes();
 	}
+	countStatistic(&HotPathStatistics::bytesCopied, count * sizeof(T));
 	std::size_t curChunkIdx = dest.m_curChunkIdx;
 
 	std::size_t blockMemLeft = dest.m_curChunkSize - dest.m_curTIdx;
 
-	T* destPtr = (*(dest.m_chunks))[curChunkIdx].first + dest.m_curTIdx;
+	T* destPtr = dest.m_chunks->pointer(curChunkIdx) + dest.m_curTIdx;
 	const T* srcPtr = static_cast<const T*>(src);
 
 	auto memoryOver = false;
@@ -452,41 +537,44 @@ VirtualPointer<T>& memcpy(VirtualPointer<T>& dest, const void* src, std::size_t
 		if (!blockMemLeft)
 		{
 			++curChunkIdx;
-			if (dest.m_chunks->size() <= curChunkIdx)
+			if (AccessPolicy::CHECK_BOUNDS && dest.m_chunks->size() <= curChunkIdx)
 			{
 				memoryOver = true;
 			}
 			else
 			{
-				destPtr = (*(dest.m_chunks))[curChunkIdx].first;
-				blockMemLeft = (*(dest.m_chunks))[curChunkIdx].second;
+				destPtr = dest.m_chunks->pointer(curChunkIdx);
+				blockMemLeft = dest.m_chunks->length(curChunkIdx);
 			}
 		}
 	}
 }
 
-template <typename T>
-void* memcpy(void* dest, const VirtualPointer<T>& src, std::size_t count)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+void* memcpy(void* dest, const VirtualPointer<T, AccessPolicy, ChunkTable>& src, std::size_t count)
 {
 	if (!count)
 	{
 		return dest;
 	}
-	if (!dest || src.m_chunks->empty())
+	if (AccessPolicy::CHECK_BOUNDS)
 	{
-		throw NullPointerException();
-	}
-	if (src.outOfRange())
-	{
-		throw std::out_of_range("Attempt to go abroad the memory");
+		if (!dest || src.m_chunks->empty())
+		{
+			throw NullPointerException();
+		}
+		if (src.outOfRange())
+		{
+			throw std::out_of_range("Attempt to go abroad the memory");
+		}
 	}
-
+	countStatistic(&HotPathStatistics::bytesCopied, count * sizeof(T));
 	std::size_t curSrcChunkIdx = src.m_curChunkIdx;
 
 	std::size_t srcBlockMemLeft = src.m_curChunkSize - src.m_curTIdx;
 
 	T* destPtr = static_cast<T*>(dest);
-	const T* srcPtr = (*(src.m_chunks))[curSrcChunkIdx].first + src.m_curTIdx;
+	const T* srcPtr = src.m_chunks->pointer(curSrcChunkIdx) + src.m_curTIdx;
 
 	auto memoryOver = false;
 
@@ -509,33 +597,36 @@ void* memcpy(void* dest, const VirtualPointer<T>& src, std::size_t count)
 		if (!srcBlockMemLeft)
 		{
 			++curSrcChunkIdx;
-			if (src.m_chunks->size() <= curSrcChunkIdx)
+			if (AccessPolicy::CHECK_BOUNDS && src.m_chunks->size() <= curSrcChunkIdx)
 			{
 				memoryOver = true;
 			}
 			else
 			{
-				srcPtr = (*(src.m_chunks))[curSrcChunkIdx].first;
-				srcBlockMemLeft = (*(src.m_chunks))[curSrcChunkIdx].second;
+				srcPtr = src.m_chunks->pointer(curSrcChunkIdx);
+				srcBlockMemLeft = src.m_chunks->length(curSrcChunkIdx);
 			}
 		}
 	}
 }
 
-template <typename T>
-VirtualPointer<T>& memmove(VirtualPointer<T>& dest, const VirtualPointer<T>& src, std::size_t count)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable>& memmove(VirtualPointer<T, AccessPolicy, ChunkTable>& dest, const VirtualPointer<T, AccessPolicy, ChunkTable>& src, std::size_t count)
 {
 	if (!count)
 	{
 		return dest;
 	}
-	if (dest.m_chunks->empty() || src.m_chunks->empty())
-	{
-		throw NullPointerException();
-	}
-	if (dest.outOfRangeWithRevalidateIndexes() || src.outOfRange())
+	if (AccessPolicy::CHECK_BOUNDS)
 	{
-		throw std::out_of_range("Attempt to go abroad the memory");
+		if (dest.m_chunks->empty() || src.m_chunks->empty())
+		{
+			throw NullPointerException();
+		}
+		if (dest.outOfRangeWithRevalidateIndexes() || src.outOfRange())
+		{
+			throw std::out_of_range("Attempt to go abroad the memory");
+		}
 	}
 	T* extraMem = new T[count];
 	if (!extraMem)
@@ -556,20 +647,23 @@ VirtualPointer<T>& memmove(VirtualPointer<T>& dest, const VirtualPointer<T>& src
 	return dest;
 }
 
-template <typename T>
-VirtualPointer<T>& memmove(VirtualPointer<T>& dest, const void* src, std::size_t count)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable>& memmove(VirtualPointer<T, AccessPolicy, ChunkTable>& dest, const void* src, std::size_t count)
 {
 	if (!count)
 	{
 		return dest;
 	}
-	if (dest.m_chunks->empty() || !src)
-	{
-		throw NullPointerException();
-	}
-	if (dest.outOfRangeWithRevalidateIndexes())
+	if (AccessPolicy::CHECK_BOUNDS)
 	{
-		throw std::out_of_range("Attempt to go abroad the memory");
+		if (dest.m_chunks->empty() || !src)
+		{
+			throw NullPointerException();
+		}
+		if (dest.outOfRangeWithRevalidateIndexes())
+		{
+			throw std::out_of_range("Attempt to go abroad the memory");
+		}
 	}
 	T* extraMem = new T[count];
 	if (!extraMem)
@@ -590,20 +684,23 @@ VirtualPointer<T>& memmove(VirtualPointer<T>& dest, const void* src, std::size_t
 	return dest;
 }
 
-template <typename T>
-void* memmove(void* dest, const VirtualPointer<T>& src, std::size_t count)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+void* memmove(void* dest, const VirtualPointer<T, AccessPolicy, ChunkTable>& src, std::size_t count)
 {
 	if (!count)
 	{
 		return dest;
 	}
-	if (!dest || src.m_chunks->empty())
-	{
-		throw NullPointerException();
-	}
-	if (src.outOfRange())
+	if (AccessPolicy::CHECK_BOUNDS)
 	{
-		throw std::out_of_range("Attempt to go abroad the memory");
+		if (!dest || src.m_chunks->empty())
+		{
+			throw NullPointerException();
+		}
+		if (src.outOfRange())
+		{
+			throw std::out_of_range("Attempt to go abroad the memory");
+		}
 	}
 	T* extraMem = new T[count];
 	if (!extraMem)
@@ -624,45 +721,47 @@ void* memmove(void* dest, const VirtualPointer<T>& src, std::size_t count)
 	return dest;
 }
 
-template <typename T>
-VirtualPointer<T> operator+(VirtualPointer<T> ptr, const std::size_t& shift)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable> operator+(VirtualPointer<T, AccessPolicy, ChunkTable> ptr, const std::size_t& shift)
 {
 	return ptr += shift;
 }
 
-template <typename T>
-VirtualPointer<T> operator+(const std::size_t& shift, VirtualPointer<T> ptr)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable> operator+(const std::size_t& shift, VirtualPointer<T, AccessPolicy, ChunkTable> ptr)
 {
 	return ptr += shift;
 }
 
-template <typename T>
-VirtualPointer<T>& VirtualPointer<T>::operator--()
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable>& VirtualPointer<T, AccessPolicy, ChunkTable>::operator--()
 {
 	toPrevElement();
 	return *this;
 }
 
-template <typename T>
-VirtualPointer<T> VirtualPointer<T>::operator--(int)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable> VirtualPointer<T, AccessPolicy, ChunkTable>::operator--(int)
 {
-	VirtualPointer<T> out = VirtualPointer<T>(*this);
+	VirtualPointer out = VirtualPointer(*this);
 	toPrevElement();
 	return out;
 }
 
-template <typename T>
-VirtualPointer<T>& VirtualPointer<T>::operator-=(const std::size_t shift)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable>& VirtualPointer<T, AccessPolicy, ChunkTable>::operator-=(const std::size_t shift)
 {
 	std::size_t localShift = shift;
 	increaseBytesRemaining(shift * sizeof(T));
+	countStatistic(&HotPathStatistics::seeks);
 	while (static_cast<size_t>(m_curTIdx) < localShift)
 	{
 		if (m_curChunkIdx)
 		{
 			localShift -= m_curTIdx + 1;
 			--m_curChunkIdx;
-			m_curChunkSize = (*m_chunks)[m_curChunkIdx].second;
+			countStatistic(&HotPathStatistics::chunkCrossings);
+			m_curChunkSize = m_chunks->length(m_curChunkIdx);
 			m_curTIdx = m_curChunkSize - 1;
 		}
 		else
@@ -673,14 +772,17 @@ VirtualPointer<T>& VirtualPointer<T>::operator-=(const std::size_t shift)
 		}
 	}
 	m_curTIdx -= localShift;
-	m_pCurrentChunk = (*m_chunks)[m_curChunkIdx].first;
+	m_pCurrentChunk = m_chunks->pointer(m_curChunkIdx);
 	return *this;
 }
 
-template <typename T>
-T& VirtualPointer<T>::operator[](std::size_t idx)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+T& VirtualPointer<T, AccessPolicy, ChunkTable>::operator[](std::size_t idx)
 {
-	revalidateIndexes();
+	if (AccessPolicy::CHECK_BOUNDS)
+	{
+		revalidateIndexes();
+	}
 	std::size_t curChunkIdx = m_curChunkIdx;
 	std::size_t curTIdx = m_curTIdx;
 	std::size_t curChunkSize = m_curChunkSize;
@@ -689,57 +791,58 @@ T& VirtualPointer<T>::operator[](std::size_t idx)
 		idx -= curChunkSize - curTIdx;
 		curTIdx = 0;
 		++curChunkIdx;
-		curChunkSize = (*m_chunks)[curChunkIdx].second;
+		curChunkSize = m_chunks->length(curChunkIdx);
 		while (idx >= curChunkSize)
 		{
 			idx -= curChunkSize;
 			++curChunkIdx;
-			curChunkSize = (*m_chunks)[curChunkIdx].second;
+			curChunkSize = m_chunks->length(curChunkIdx);
 		}
 	}
 	curTIdx += idx;
-	return (*m_chunks)[curChunkIdx].first[curTIdx];
+	return m_chunks->pointer(curChunkIdx)[curTIdx];
 }
 
-template <typename T>
-const T& VirtualPointer<T>::operator[](std::size_t idx) const
+template <typename T, typename AccessPolicy, typename ChunkTable>
+const T& VirtualPointer<T, AccessPolicy, ChunkTable>::operator[](std::size_t idx) const
 {
-	VirtualPointer<T> tmp = *this;
+	VirtualPointer tmp = *this;
 	return *(tmp += idx);
 }
 
-template <typename T>
-VirtualPointer<T> operator-(VirtualPointer<T> ptr, const std::size_t& shift)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable> operator-(VirtualPointer<T, AccessPolicy, ChunkTable> ptr, const std::size_t& shift)
 {
 	return ptr -= shift;
 }
 
-template <typename T>
-T& VirtualPointer<T>::operator*()
+template <typename T, typename AccessPolicy, typename ChunkTable>
+T& VirtualPointer<T, AccessPolicy, ChunkTable>::operator*()
 {
-	revalidateIndexes();
+	if (AccessPolicy::CHECK_BOUNDS)
+	{
+		revalidateIndexes();
+	}
 	return *(m_pCurrentChunk + m_curTIdx);
 }
 
-template <typename T>
-void VirtualPointer<T>::addChunk(T* ptr, std::size_t length)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+void VirtualPointer<T, AccessPolicy, ChunkTable>::addChunk(T* ptr, std::size_t length)
 {
 	if (length)
 	{
 		if (nullptr != ptr)
 		{
-			bool tryShiftChunkIdx = false;
-			if (outOfRangeWithRevalidateIndexes())
+			const bool wasOutOfRange = outOfRangeWithRevalidateIndexes();
+			const bool tryShiftChunkIdx = wasOutOfRange && !m_chunks->empty();
+			// the chunk table can reject the chunk, so the state is changed after the chunk is added
+			m_chunks->append(ptr, length);
+			if (wasOutOfRange)
 			{
 				m_curTIdx -= m_curChunkSize;
 				m_curChunkSize = length;
-				tryShiftChunkIdx = true;
-			}
-			if (m_chunks->empty())
-			{
-				tryShiftChunkIdx = false;
 			}
-			m_chunks->emplace_back(std::pair<T*, std::size_t>(ptr, length));
+			countStatistic(&HotPathStatistics::chunkTableGrowth);
 			if (static_cast<size_t>(m_curTIdx) < m_curChunkSize)
 			{
 				if (tryShiftChunkIdx)
@@ -747,14 +850,14 @@ void VirtualPointer<T>::addChunk(T* ptr, std::size_t length)
 					m_curChunkIdx++;
 				}
 			}
-			m_pCurrentChunk = (*m_chunks)[m_curChunkIdx].first;
+			m_pCurrentChunk = m_chunks->pointer(m_curChunkIdx);
 			validateBytesRemaining();
 		}
 	}
 }
 
-template <typename T>
-void VirtualPointer<T>::addChunk(const VirtualPointer& src, std::size_t count)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+void VirtualPointer<T, AccessPolicy, ChunkTable>::addChunk(const VirtualPointer& src, std::size_t count)
 {
 	if (src.outOfRange())
 	{
@@ -769,23 +872,23 @@ void VirtualPointer<T>::addChunk(const VirtualPointer& src, std::size_t count)
 	const auto wasEmpty = m_chunks->empty();
 	while (again)
 	{
-		if ((*(src.m_chunks))[curSrcChunkIdx].second >= count + curSrcTIdx)
+		countStatistic(&HotPathStatistics::chunkTableGrowth);
+		if (src.m_chunks->length(curSrcChunkIdx) >= count + curSrcTIdx)
 		{
-			m_chunks->emplace_back(std::pair<T*, std::size_t>((*(src.m_chunks))[curSrcChunkIdx].first + curSrcTIdx, count));
+			m_chunks->append(src.m_chunks->pointer(curSrcChunkIdx) + curSrcTIdx, count);
 			again = false;
 		}
 		else
 		{
-			m_chunks->emplace_back(std::pair<T*, std::size_t>(
-					(*(src.m_chunks))[curSrcChunkIdx].first + curSrcTIdx,
-					(*(src.m_chunks))[curSrcChunkIdx].second - curSrcTIdx
-				)
+			m_chunks->append(
+				src.m_chunks->pointer(curSrcChunkIdx) + curSrcTIdx,
+				src.m_chunks->length(curSrcChunkIdx) - curSrcTIdx
 			);
-			count -= (*(src.m_chunks))[curSrcChunkIdx].second - curSrcTIdx;
+			count -= src.m_chunks->length(curSrcChunkIdx) - curSrcTIdx;
 		}
 		if (curOutOfRange)
 		{
-			if ((*(src.m_chunks))[curSrcChunkIdx].second - curSrcTIdx >= (curTIdx - m_curChunkSize))
+			if (src.m_chunks->length(curSrcChunkIdx) - curSrcTIdx >= (curTIdx - m_curChunkSize))
 			{
 				// out of range and zero curTIdx both mean this was empty
 				if (curTIdx)
@@ -800,7 +903,7 @@ void VirtualPointer<T>::addChunk(const VirtualPointer& src, std::size_t count)
 			}
 			else
 			{
-				curTIdx -= (*m_chunks)[curChunkIdx].second;
+				curTIdx -= m_chunks->length(curChunkIdx);
 			}
 			++curChunkIdx;
 			if (curTIdx < static_cast<signed_size_t>(m_curChunkSize))
@@ -813,22 +916,154 @@ void VirtualPointer<T>::addChunk(const VirtualPointer& src, std::size_t count)
 	}
 	m_curTIdx = curTIdx;
 	m_curChunkIdx = curChunkIdx;
-	m_pCurrentChunk = (*m_chunks)[m_curChunkIdx].first;
-	m_curChunkSize = (*m_chunks)[m_curChunkIdx].second;
+	m_pCurrentChunk = m_chunks->pointer(m_curChunkIdx);
+	m_curChunkSize = m_chunks->length(m_curChunkIdx);
 	validateBytesRemaining();
 }
 
-template <typename T>
-std::size_t VirtualPointer<T>::bytesRemaining() const
+template <typename T, typename AccessPolicy, typename ChunkTable>
+void VirtualPointer<T, AccessPolicy, ChunkTable>::insert(const std::size_t pos, T* ptr, const std::size_t length)
+{
+	if (!length || nullptr == ptr)
+	{
+		return;
+	}
+	const std::size_t offset = editOffset(pos, 0);
+	const signed_size_t position = absolutePosition();
+	auto chunks = std::make_shared<ChunkTable>(*m_chunks);
+	const std::size_t idx = splitChunk(*chunks, offset);
+	chunks->insert(idx, ptr, length);
+	countStatistic(&HotPathStatistics::chunkTableGrowth);
+	replaceChunks(std::move(chunks), position);
+}
+
+template <typename T, typename AccessPolicy, typename ChunkTable>
+void VirtualPointer<T, AccessPolicy, ChunkTable>::erase(const std::size_t pos, const std::size_t count)
+{
+	if (!count)
+	{
+		return;
+	}
+	const std::size_t offset = editOffset(pos, count);
+	const signed_size_t position = absolutePosition();
+	auto chunks = std::make_shared<ChunkTable>(*m_chunks);
+	const std::size_t first = splitChunk(*chunks, offset);
+	const std::size_t last = splitChunk(*chunks, offset + count);
+	chunks->erase(first, last);
+	replaceChunks(std::move(chunks), position);
+}
+
+template <typename T, typename AccessPolicy, typename ChunkTable>
+void VirtualPointer<T, AccessPolicy, ChunkTable>::splice(const std::size_t pos, const VirtualPointer& src)
+{
+	const signed_size_t srcPosition = src.absolutePosition();
+	// src can share the chunk table with this pointer, so its chunks are taken from a copy of its table
+	ChunkTable tail(*src.m_chunks);
+	if (srcPosition < 0 || static_cast<std::size_t>(srcPosition) >= tail.offset(tail.size()))
+	{
+		throw std::out_of_range("Attempt to add from outside of the memory");
+	}
+	const std::size_t first = splitChunk(tail, srcPosition);
+	const std::size_t offset = editOffset(pos, 0);
+	const signed_size_t position = absolutePosition();
+	auto chunks = std::make_shared<ChunkTable>(*m_chunks);
+	const std::size_t idx = splitChunk(*chunks, offset);
+	chunks->insert(idx, tail, first);
+	countStatistic(&HotPathStatistics::chunkTableGrowth, tail.size() - first);
+	replaceChunks(std::move(chunks), position);
+}
+
+template <typename T, typename AccessPolicy, typename ChunkTable>
+typename VirtualPointer<T, AccessPolicy, ChunkTable>::signed_size_t VirtualPointer<T, AccessPolicy, ChunkTable>::absolutePosition() const
+{
+	return m_curTIdx + static_cast<signed_size_t>(m_chunks->offset(std::min(m_curChunkIdx, m_chunks->size())));
+}
+
+template <typename T, typename AccessPolicy, typename ChunkTable>
+std::size_t VirtualPointer<T, AccessPolicy, ChunkTable>::editOffset(const std::size_t pos, const std::size_t count) const
+{
+	const std::size_t total = m_chunks->offset(m_chunks->size());
+	const signed_size_t offset = absolutePosition() + static_cast<signed_size_t>(pos);
+	if (offset < 0 || static_cast<std::size_t>(offset) > total || total - offset < count)
+	{
+		throw std::out_of_range("Attempt to go abroad the memory");
+	}
+	return offset;
+}
+
+template <typename T, typename AccessPolicy, typename ChunkTable>
+std::size_t VirtualPointer<T, AccessPolicy, ChunkTable>::splitChunk(ChunkTable& chunks, std::size_t offset)
+{
+	std::size_t idx = chunks.find(offset);
+	if (offset)
+	{
+		chunks.insert(idx + 1, chunks.pointer(idx) + offset, chunks.length(idx) - offset);
+		chunks.setLength(idx, offset);
+		++idx;
+	}
+	return idx;
+}
+
+template <typename T, typename AccessPolicy, typename ChunkTable>
+void VirtualPointer<T, AccessPolicy, ChunkTable>::replaceChunks(std::shared_ptr<ChunkTable> chunks, const signed_size_t position)
+{
+	m_chunks = std::move(chunks);
+	const std::size_t total = m_chunks->offset(m_chunks->size());
+	m_curChunkIdx = 0;
+	m_curTIdx = position;
+	m_pCurrentChunk = nullptr;
+	m_curChunkSize = 0;
+	if (!m_chunks->empty())
+	{
+		if (position >= 0)
+		{
+			std::size_t offset = position;
+			m_curChunkIdx = m_chunks->find(offset);
+			// the position at the end of the memory stays in the last chunk
+			if (m_curChunkIdx == m_chunks->size())
+			{
+				--m_curChunkIdx;
+				offset += m_chunks->length(m_curChunkIdx);
+			}
+			m_curTIdx = offset;
+		}
+		m_curChunkSize = m_chunks->length(m_curChunkIdx);
+		m_pCurrentChunk = m_chunks->pointer(m_curChunkIdx);
+	}
+	m_bytesRemaining = (total - position) * sizeof(T);
+	m_endVectorIndex = m_chunks->size();
+}
+
+template <typename T, typename AccessPolicy, typename ChunkTable>
+std::size_t VirtualPointer<T, AccessPolicy, ChunkTable>::bytesRemaining() const
 {
 	validateBytesRemaining();
 	return m_bytesRemaining;
 }
 
-template <typename T>
-inline void VirtualPointer<T>::clear()
+template <typename T, typename AccessPolicy, typename ChunkTable>
+T* VirtualPointer<T, AccessPolicy, ChunkTable>::contiguousData(std::size_t& count) const
 {
-	m_chunks = std::make_shared<std::vector<std::pair<T*, std::size_t>>>();
+	std::size_t curChunkIdx = m_curChunkIdx;
+	signed_size_t curTIdx = m_curTIdx;
+	while (curChunkIdx < m_chunks->size() && curTIdx >= static_cast<signed_size_t>(m_chunks->length(curChunkIdx)))
+	{
+		curTIdx -= m_chunks->length(curChunkIdx);
+		++curChunkIdx;
+	}
+	if (curTIdx < 0 || curChunkIdx >= m_chunks->size())
+	{
+		count = 0;
+		return nullptr;
+	}
+	count = m_chunks->length(curChunkIdx) - curTIdx;
+	return m_chunks->pointer(curChunkIdx) + curTIdx;
+}
+
+template <typename T, typename AccessPolicy, typename ChunkTable>
+inline void VirtualPointer<T, AccessPolicy, ChunkTable>::clear()
+{
+	m_chunks = std::make_shared<ChunkTable>();
 	m_pCurrentChunk = nullptr;
 	m_curChunkIdx = 0;
 	m_curTIdx = 0;
@@ -837,26 +1072,54 @@ inline void VirtualPointer<T>::clear()
 	m_endVectorIndex = 0;
 }
 
-template <typename T>
-inline bool VirtualPointer<T>::isOverflow() const
+template <typename T, typename AccessPolicy, typename ChunkTable>
+VirtualPointer<T, AccessPolicy, ChunkTable> VirtualPointer<T, AccessPolicy, ChunkTable>::fork() const
+{
+	VirtualPointer out(*this);
+	out.m_chunks = std::make_shared<ChunkTable>(*m_chunks);
+	return out;
+}
+
+template <typename T, typename AccessPolicy, typename ChunkTable>
+inline typename VirtualPointer<T, AccessPolicy, ChunkTable>::Position VirtualPointer<T, AccessPolicy, ChunkTable>::getPosition() const
+{
+	return Position{ m_pCurrentChunk, m_curChunkIdx, m_curTIdx, m_curChunkSize, m_bytesRemaining, m_endVectorIndex };
+}
+
+template <typename T, typename AccessPolicy, typename ChunkTable>
+inline void VirtualPointer<T, AccessPolicy, ChunkTable>::setPosition(const Position& position)
+{
+	m_pCurrentChunk = position.pCurrentChunk;
+	m_curChunkIdx = position.curChunkIdx;
+	m_curTIdx = position.curTIdx;
+	m_curChunkSize = position.curChunkSize;
+	m_bytesRemaining = position.bytesRemaining;
+	m_endVectorIndex = position.endVectorIndex;
+}
+
+template <typename T, typename AccessPolicy, typename ChunkTable>
+inline bool VirtualPointer<T, AccessPolicy, ChunkTable>::isOverflow() const
 {
 	return outOfRange();
 }
 
-template <typename T>
-int memcmp(const VirtualPointer<T>& dest, const VirtualPointer<T>& src, std::size_t count)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+int memcmp(const VirtualPointer<T, AccessPolicy, ChunkTable>& dest, const VirtualPointer<T, AccessPolicy, ChunkTable>& src, std::size_t count)
 {
 	if (!count)
 	{
 		return 0;
 	}
-	if (src.m_chunks->empty() || dest.m_chunks->empty())
-	{
-		throw NullPointerException();
-	}
-	if (dest.outOfRange() || src.outOfRange())
+	if (AccessPolicy::CHECK_BOUNDS)
 	{
-		throw std::out_of_range("Attempt to go abroad the memory");
+		if (src.m_chunks->empty() || dest.m_chunks->empty())
+		{
+			throw NullPointerException();
+		}
+		if (dest.outOfRange() || src.outOfRange())
+		{
+			throw std::out_of_range("Attempt to go abroad the memory");
+		}
 	}
 	std::size_t curChunkIdx = dest.m_curChunkIdx;
 
@@ -865,8 +1128,8 @@ int memcmp(const VirtualPointer<T>& dest, const VirtualPointer<T>& src, std::siz
 	std::size_t blockMemLeft = dest.m_curChunkSize - dest.m_curTIdx;
 	std::size_t srcBlockMemLeft = src.m_curChunkSize - src.m_curTIdx;
 
-	T* destPtr = (*(dest.m_chunks))[curChunkIdx].first + dest.m_curTIdx;
-	const T* srcPtr = (*(src.m_chunks))[curSrcChunkIdx].first + src.m_curTIdx;
+	T* destPtr = dest.m_chunks->pointer(curChunkIdx) + dest.m_curTIdx;
+	const T* srcPtr = src.m_chunks->pointer(curSrcChunkIdx) + src.m_curTIdx;
 
 	auto memoryOver = false;
 
@@ -894,52 +1157,55 @@ int memcmp(const VirtualPointer<T>& dest, const VirtualPointer<T>& src, std::siz
 		if (!blockMemLeft)
 		{
 			++curChunkIdx;
-			if (dest.m_chunks->size() <= curChunkIdx)
+			if (AccessPolicy::CHECK_BOUNDS && dest.m_chunks->size() <= curChunkIdx)
 			{
 				memoryOver = true;
 			}
 			else
 			{
-				destPtr = (*(dest.m_chunks))[curChunkIdx].first;
-				blockMemLeft = (*(dest.m_chunks))[curChunkIdx].second;
+				destPtr = dest.m_chunks->pointer(curChunkIdx);
+				blockMemLeft = dest.m_chunks->length(curChunkIdx);
 			}
 		}
 		if (!srcBlockMemLeft)
 		{
 			++curSrcChunkIdx;
-			if (src.m_chunks->size() <= curSrcChunkIdx)
+			if (AccessPolicy::CHECK_BOUNDS && src.m_chunks->size() <= curSrcChunkIdx)
 			{
 				memoryOver = true;
 			}
 			else
 			{
-				srcPtr = (*(src.m_chunks))[curSrcChunkIdx].first;
-				srcBlockMemLeft = (*(src.m_chunks))[curSrcChunkIdx].second;
+				srcPtr = src.m_chunks->pointer(curSrcChunkIdx);
+				srcBlockMemLeft = src.m_chunks->length(curSrcChunkIdx);
 			}
 		}
 	}
 }
 
-template <typename T>
-int memcmp(const VirtualPointer<T>& dest, const void* src, std::size_t count)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+int memcmp(const VirtualPointer<T, AccessPolicy, ChunkTable>& dest, const void* src, std::size_t count)
 {
 	if (!count)
 	{
 		return 0;
 	}
-	if (!src || dest.m_chunks->empty())
-	{
-		throw NullPointerException();
-	}
-	if (dest.outOfRange())
+	if (AccessPolicy::CHECK_BOUNDS)
 	{
-		throw std::out_of_range("Attempt to go abroad the memory");
+		if (!src || dest.m_chunks->empty())
+		{
+			throw NullPointerException();
+		}
+		if (dest.outOfRange())
+		{
+			throw std::out_of_range("Attempt to go abroad the memory");
+		}
 	}
 	std::size_t curChunkIdx = dest.m_curChunkIdx;
 
 	std::size_t blockMemLeft = dest.m_curChunkSize - dest.m_curTIdx;
 
-	T* destPtr = (*(dest.m_chunks))[curChunkIdx].first + dest.m_curTIdx;
+	T* destPtr = dest.m_chunks->pointer(curChunkIdx) + dest.m_curTIdx;
 	const T* srcPtr = static_cast<const T*>(src);
 
 	auto memoryOver = false;
@@ -967,33 +1233,36 @@ int memcmp(const VirtualPointer<T>& dest, const void* src, std::size_t count)
 		if (!blockMemLeft)
 		{
 			++curChunkIdx;
-			if (dest.m_chunks->size() <= curChunkIdx)
+			if (AccessPolicy::CHECK_BOUNDS && dest.m_chunks->size() <= curChunkIdx)
 			{
 				memoryOver = true;
 			}
 			else
 			{
-				destPtr = (*(dest.m_chunks))[curChunkIdx].first;
-				blockMemLeft = (*(dest.m_chunks))[curChunkIdx].second;
+				destPtr = dest.m_chunks->pointer(curChunkIdx);
+				blockMemLeft = dest.m_chunks->length(curChunkIdx);
 			}
 		}
 	}
 }
 
-template <typename T>
-int memcmp(const void* dest, const VirtualPointer<T>& src, std::size_t count)
+template <typename T, typename AccessPolicy, typename ChunkTable>
+int memcmp(const void* dest, const VirtualPointer<T, AccessPolicy, ChunkTable>& src, std::size_t count)
 {
 	if (!count)
 	{
 		return 0;
 	}
-	if (!dest || src.m_chunks->empty())
-	{
-		throw NullPointerException();
-	}
-	if (src.outOfRange())
+	if (AccessPolicy::CHECK_BOUNDS)
 	{
-		throw std::out_of_range("Attempt to go abroad the memory");
+		if (!dest || src.m_chunks->empty())
+		{
+			throw NullPointerException();
+		}
+		if (src.outOfRange())
+		{
+			throw std::out_of_range("Attempt to go abroad the memory");
+		}
 	}
 
 	std::size_t curSrcChunkIdx = src.m_curChunkIdx;
@@ -1001,7 +1270,7 @@ int memcmp(const void* dest, const VirtualPointer<T>& src, std::size_t count)
 	std::size_t srcBlockMemLeft = src.m_curChunkSize - src.m_curTIdx;
 
 	const T* destPtr = static_cast<const T*>(dest);
-	const T* srcPtr = (*(src.m_chunks))[curSrcChunkIdx].first + src.m_curTIdx;
+	const T* srcPtr = src.m_chunks->pointer(curSrcChunkIdx) + src.m_curTIdx;
 
 	auto memoryOver = false;
 
@@ -1028,22 +1297,22 @@ int memcmp(const void* dest, const VirtualPointer<T>& src, std::size_t count)
 		if (!srcBlockMemLeft)
 		{
 			++curSrcChunkIdx;
-			if (src.m_chunks->size() <= curSrcChunkIdx)
+			if (AccessPolicy::CHECK_BOUNDS && src.m_chunks->size() <= curSrcChunkIdx)
 			{
 				memoryOver = true;
 			}
 			else
 			{
-				srcPtr = (*(src.m_chunks))[curSrcChunkIdx].first;
-				srcBlockMemLeft = (*(src.m_chunks))[curSrcChunkIdx].second;
+				srcPtr = src.m_chunks->pointer(curSrcChunkIdx);
+				srcBlockMemLeft = src.m_chunks->length(curSrcChunkIdx);
 			}
 		}
 	}
 }
 
 
-template <typename T>
-void VirtualPointer<T>::toNextElement()
+template <typename T, typename AccessPolicy, typename ChunkTable>
+void VirtualPointer<T, AccessPolicy, ChunkTable>::toNextElement()
 {
 	if (m_curTIdx + 1 < 0 || m_curTIdx + 1 < static_cast<signed_size_t>(m_curChunkSize) || m_curChunkIdx + 1 >= m_chunks->size())
 	{
@@ -1053,23 +1322,24 @@ void VirtualPointer<T>::toNextElement()
 	{
 		m_curTIdx = 0;
 		++m_curChunkIdx;
-		const auto& pair = (*m_chunks)[m_curChunkIdx];
-		m_pCurrentChunk = pair.first;
-		m_curChunkSize = pair.second;
+		countStatistic(&HotPathStatistics::chunkCrossings);
+		m_pCurrentChunk = m_chunks->pointer(m_curChunkIdx);
+		m_curChunkSize = m_chunks->length(m_curChunkIdx);
 	}
 	decreaseBytesRemaining(sizeof(T));
 }
 
-template <typename T>
-void VirtualPointer<T>::toPrevElement()
+template <typename T, typename AccessPolicy, typename ChunkTable>
+void VirtualPointer<T, AccessPolicy, ChunkTable>::toPrevElement()
 {
 	increaseBytesRemaining(sizeof(T));
 	--m_curTIdx;
 	while(m_curTIdx < 0 && 0 != m_curChunkIdx)
 	{
 		--m_curChunkIdx;
-		m_pCurrentChunk = (*m_chunks)[m_curChunkIdx].first;
-		m_curChunkSize = (*m_chunks)[m_curChunkIdx].second;
+		countStatistic(&HotPathStatistics::chunkCrossings);
+		m_pCurrentChunk = m_chunks->pointer(m_curChunkIdx);
+		m_curChunkSize = m_chunks->length(m_curChunkIdx);
 		m_curTIdx += m_curChunkSize;
 	}
 }
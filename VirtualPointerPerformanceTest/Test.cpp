@@ -8,11 +8,12 @@
 using namespace std;
 using namespace std::chrono;
 
-using byte = uint8_t;
+// std::byte is visible through the using directive since C++17
+using byte_t = uint8_t;
 
-void initializeOriginalVector(vector<byte>& v)
+void initializeOriginalVector(vector<byte_t>& v)
 {
-	byte i = 0;
+	byte_t i = 0;
 	for (auto& element : v) {
 		element = i;
 		++i;
@@ -27,13 +28,13 @@ Test::Test(std::fstream& logsStream, std::ostream& avoidOptimizationStream) :
 
 void Test::run()
 {
-	m_originalArray = vector<byte>(m_summaryPacketSize);
-	m_decoderArray = vector<byte>(m_summaryPacketSize);
-	m_intermediateBuffers = vector<vector<byte>>(m_depth);
+	m_originalArray = vector<byte_t>(m_summaryPacketSize);
+	m_decoderArray = vector<byte_t>(m_summaryPacketSize);
+	m_intermediateBuffers = vector<vector<byte_t>>(m_depth);
 
 	for(size_t i = 0; i < m_depth; ++i)
 	{
-		m_intermediateBuffers[i] = vector<byte>(m_summaryPacketSize);
+		m_intermediateBuffers[i] = vector<byte_t>(m_summaryPacketSize);
 	}
 
 	initializeOriginalVector(m_originalArray);
@@ -79,12 +80,12 @@ std::chrono::duration<double> Test::getVptrDuration() const
 }
 
 template<typename Ptr>
-void copyToDecoderBuffer(std::vector<byte>& decoderBuffer, Ptr& lastLevel, size_t lastLevelSize)
+void copyToDecoderBuffer(std::vector<byte_t>& decoderBuffer, Ptr& lastLevel, size_t lastLevelSize)
 {
 	memcpy(decoderBuffer.data(), lastLevel, lastLevelSize);
 }
 
-size_t copyDeepDown(vector<byte>& to, vector<byte>& from, const size_t fromSize, const size_t headerSize, const size_t payloadSize)
+size_t copyDeepDown(vector<byte_t>& to, vector<byte_t>& from, const size_t fromSize, const size_t headerSize, const size_t payloadSize)
 {
 	const auto minSize = fromSize - fromSize % (headerSize + payloadSize);
 	size_t toId = 0;
@@ -96,7 +97,7 @@ size_t copyDeepDown(vector<byte>& to, vector<byte>& from, const size_t fromSize,
 	return toId;
 }
 
-void copyOutside(vector<byte>& to, vector<byte>& from, const size_t toSize, const size_t headerSize, const size_t payloadSize)
+void copyOutside(vector<byte_t>& to, vector<byte_t>& from, const size_t toSize, const size_t headerSize, const size_t payloadSize)
 {
 	const auto minSize = toSize - toSize % (headerSize + payloadSize);
 	
@@ -151,7 +152,7 @@ void Test::recursiveCopy(const size_t idxTo, const size_t idxFrom, const size_t
 
 void Test::recursiveVptr()
 {
-	VirtualPointer<byte> vptr{};
+	VirtualPointer<byte_t> vptr{};
 
 	const size_t minSize = m_summaryPacketSize - m_summaryPacketSize % static_cast<size_t>(m_headerSize + m_payloadSize);
 	for (size_t fromId = 0; fromId < minSize - 1; fromId += m_payloadSize)
@@ -174,9 +175,9 @@ void Test::recursiveVptr()
 	}
 }
 
-void Test::recursiveVptr(VirtualPointer<byte>& majorVptr, const size_t depth)
+void Test::recursiveVptr(VirtualPointer<byte_t>& majorVptr, const size_t depth)
 {
-	VirtualPointer<byte> vptr{};
+	VirtualPointer<byte_t> vptr{};
 	
 	for (auto fromVptr = majorVptr; fromVptr.bytesRemaining() >= static_cast<size_t>(m_headerSize + m_payloadSize); fromVptr += m_payloadSize)
 	{
@@ -4,8 +4,7 @@
 #include <chrono>
 #include <vector>
 
-template<typename T>
-class VirtualPointer;
+#include "VirtualPointer.h"
 
 class Test final
 {
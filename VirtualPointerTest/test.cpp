@@ -2,6 +2,9 @@
 #include "gtest/gtest.h"
 #include "VirtualPointer.h"
 
+#include <cmath>
+#include <thread>
+
 using std::size_t;
 
 /*
@@ -3250,4 +3253,577 @@ TEST(BytesRemaining, DifferentCopies)
 	BytesRemainingDifferentCopies<uint16_t>();
 	BytesRemainingDifferentCopies<uint32_t>();
 	BytesRemainingDifferentCopies<size_t>();
-}
\ No newline at end of file
+}
+
+/*
+*
+*
+*	Access policies: VirtualPointer<T, UncheckedAccess>
+*
+*
+*/
+
+TEST(UncheckedAccess, moveInDiscontinuousMemory) {
+	constexpr size_t count = 64;
+	size_t arr[count];
+	for (size_t i = 0; i < count; ++i) {
+		arr[i] = i;
+	}
+
+	VirtualPointer<size_t, UncheckedAccess> ptr{};
+	ptr.addChunk(arr, 8);
+	ptr.addChunk(arr + 16, 16);
+	ptr.addChunk(arr + 40, 24);
+
+	EXPECT_EQ(0, *ptr);
+	EXPECT_EQ(16, ptr[8]);
+	EXPECT_EQ(40, ptr[24]);
+	EXPECT_EQ(63, ptr[47]);
+
+	ptr += 8;
+	EXPECT_EQ(16, *ptr);
+	++ptr;
+	EXPECT_EQ(17, *ptr);
+	ptr += 15;
+	EXPECT_EQ(40, *ptr);
+	ptr -= 16;
+	EXPECT_EQ(16, *ptr);
+	--ptr;
+	EXPECT_EQ(7, *ptr);
+	EXPECT_EQ(41 * sizeof(size_t), ptr.bytesRemaining());
+}
+
+TEST(UncheckedAccess, memoryFunctionsInDiscontinuousMemory) {
+	constexpr size_t count = 64;
+	uint8_t src[count];
+	uint8_t dest[count] = { 0 };
+	uint8_t out[count] = { 0 };
+	for (size_t i = 0; i < count; ++i) {
+		src[i] = static_cast<uint8_t>(i);
+	}
+
+	VirtualPointer<uint8_t, UncheckedAccess> srcPtr{};
+	VirtualPointer<uint8_t, UncheckedAccess> destPtr{};
+	srcPtr.addChunk(src, 3);
+	srcPtr.addChunk(src + 3, 29);
+	destPtr.addChunk(dest, 17);
+	destPtr.addChunk(dest + 40, 15);
+
+	memcpy(destPtr, srcPtr, 32);
+	EXPECT_EQ(0, memcmp(destPtr, srcPtr, 32));
+	EXPECT_EQ(0, memcmp(dest, src, 17));
+	EXPECT_EQ(0, memcmp(dest + 40, src + 17, 15));
+
+	memset(destPtr + 16, 0xFF, 2);
+	EXPECT_EQ(0xFF, dest[16]);
+	EXPECT_EQ(0xFF, dest[40]);
+
+	memcpy(out, destPtr, 32);
+	EXPECT_EQ(0, memcmp(out, dest, 17));
+	EXPECT_EQ(0, memcmp(out + 17, dest + 40, 15));
+}
+
+// the policy of release builds, UncheckedAccess keeps the checks in the debug builds of the tests
+struct NoBoundsChecks final
+{
+	static constexpr bool CHECK_BOUNDS = false;
+};
+
+TEST(UncheckedAccess, memoryFunctionsSeeChunksAddedByCopies) {
+	uint8_t src[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	uint8_t dest[8] = { 0 };
+
+	VirtualPointer<uint8_t, NoBoundsChecks> destPtr{};
+	auto copy = destPtr;
+	copy.addChunk(dest, 4);
+	copy.addChunk(dest + 4, 4);
+
+	memset(destPtr, 0xFF, 6);
+	EXPECT_EQ(0xFF, dest[5]);
+	EXPECT_EQ(0, dest[6]);
+	memcpy(destPtr, src, 8);
+	EXPECT_EQ(0, memcmp(dest, src, 8));
+
+	VirtualPointer<uint8_t, NoBoundsChecks> srcPtr{};
+	srcPtr.addChunk(src, 8);
+	VirtualPointer<uint8_t, NoBoundsChecks> otherDest{};
+	auto otherCopy = otherDest;
+	otherCopy.addChunk(dest + 2, 6);
+	memcpy(otherDest, srcPtr, 6);
+	EXPECT_EQ(2, dest[1]);
+	EXPECT_EQ(1, dest[2]);
+	EXPECT_EQ(6, dest[7]);
+}
+
+
+
+/*
+*
+*
+*	Hot path statistics
+*
+*
+*/
+
+// the counters are kept only by the configurations defining BINARY_VIRTUALIZATION_STATISTICS
+constexpr uint64_t COUNTED = STATISTICS_ENABLED ? 1 : 0;
+
+TEST(HotPathStatistics, virtualPointerCounters) {
+	constexpr size_t count = 16;
+	size_t arr[count];
+	size_t out[count];
+	for (size_t i = 0; i < count; ++i) {
+		arr[i] = i;
+	}
+
+	resetStatistics();
+	VirtualPointer<size_t> ptr{};
+	ptr.addChunk(arr, 4);
+	ptr.addChunk(arr + 4, 4);
+	ptr.addChunk(arr + 8, 8);
+	EXPECT_EQ(3 * COUNTED, getStatisticsSnapshot().chunkTableGrowth);
+
+	ptr += 5;
+	++ptr;
+	++ptr;
+	++ptr;
+	EXPECT_EQ(8, *ptr);
+	memcpy(out, ptr, 2);
+
+	const auto statistics = getStatisticsSnapshot();
+	EXPECT_EQ(2 * COUNTED, statistics.chunkCrossings);
+	EXPECT_EQ(COUNTED, statistics.seeks);
+	EXPECT_EQ(2 * sizeof(size_t) * COUNTED, statistics.bytesCopied);
+
+	resetStatistics();
+	EXPECT_EQ(0, getStatisticsSnapshot().chunkTableGrowth);
+	EXPECT_EQ(0, getStatisticsSnapshot().chunkCrossings);
+}
+
+TEST(HotPathStatistics, countersArePerThread) {
+	size_t arr[4] = { 0 };
+	resetStatistics();
+	std::thread worker([&arr]() {
+		VirtualPointer<size_t> ptr{};
+		ptr.addChunk(arr, 2);
+		ptr.addChunk(arr + 2, 2);
+		EXPECT_EQ(2 * COUNTED, getStatisticsSnapshot().chunkTableGrowth);
+	});
+	worker.join();
+	EXPECT_EQ(0, getStatisticsSnapshot().chunkTableGrowth);
+}
+
+/*
+*
+*
+*	Editing of the view: insert, erase, splice
+*
+*
+*/
+
+template<typename ChunkTable>
+void InsertAndErase() {
+	constexpr size_t count = 32;
+	size_t arr[count];
+	size_t stuffing[4] = { 100, 101, 102, 103 };
+	for (size_t i = 0; i < count; ++i) {
+		arr[i] = i;
+	}
+
+	VirtualPointer<size_t, CheckedAccess, ChunkTable> ptr{};
+	ptr.addChunk(arr, 16);
+	ptr.addChunk(arr + 16, 16);
+	ptr += 4;
+	auto copy = ptr;
+
+	ptr.insert(6, stuffing, 4);
+	EXPECT_EQ(4, *ptr);
+	EXPECT_EQ(9, ptr[5]);
+	EXPECT_EQ(100, ptr[6]);
+	EXPECT_EQ(103, ptr[9]);
+	EXPECT_EQ(10, ptr[10]);
+	EXPECT_EQ(32 * sizeof(size_t), ptr.bytesRemaining());
+	// the copy made before the edit keeps the previous view
+	EXPECT_EQ(10, copy[6]);
+	EXPECT_EQ(28 * sizeof(size_t), copy.bytesRemaining());
+
+	// erase crosses the border of the chunks
+	ptr.erase(8, 14);
+	EXPECT_EQ(100, ptr[6]);
+	EXPECT_EQ(101, ptr[7]);
+	EXPECT_EQ(22, ptr[8]);
+	EXPECT_EQ(18 * sizeof(size_t), ptr.bytesRemaining());
+	ptr += 8;
+	EXPECT_EQ(22, *ptr);
+	ptr -= 12;
+	EXPECT_EQ(0, *ptr);
+
+	ptr.insert(0, stuffing, 1);
+	EXPECT_EQ(100, *ptr);
+	EXPECT_EQ(0, ptr[1]);
+
+	ptr.erase(0, 23);
+	EXPECT_TRUE(ptr.isOverflow());
+	EXPECT_EQ(0, ptr.bytesRemaining());
+	ptr.insert(0, stuffing + 3, 1);
+	EXPECT_EQ(103, *ptr);
+}
+
+TEST(EditView, insertAndErase) {
+	InsertAndErase<VectorChunkTable<size_t>>();
+	InsertAndErase<RopeChunkTable<size_t>>();
+}
+
+template<typename ChunkTable>
+void Splice() {
+	constexpr size_t count = 32;
+	size_t arr[count];
+	for (size_t i = 0; i < count; ++i) {
+		arr[i] = i;
+	}
+
+	VirtualPointer<size_t, CheckedAccess, ChunkTable> ptr{};
+	ptr.addChunk(arr, 8);
+	ptr.addChunk(arr + 8, 8);
+	VirtualPointer<size_t, CheckedAccess, ChunkTable> other{};
+	other.addChunk(arr + 20, 4);
+	other.addChunk(arr + 28, 4);
+	other += 2;
+
+	ptr.splice(3, other);
+	size_t expected[] = { 0, 1, 2, 22, 23, 28, 29, 30, 31, 3, 4 };
+	EXPECT_EQ(0, memcmp(ptr, expected, sizeof(expected) / sizeof(size_t)));
+	EXPECT_EQ(22 * sizeof(size_t), ptr.bytesRemaining());
+
+	// splice of itself
+	ptr += 9;
+	ptr.splice(2, ptr);
+	size_t expectedSelf[] = { 3, 4, 3, 4, 5 };
+	EXPECT_EQ(0, memcmp(ptr, expectedSelf, sizeof(expectedSelf) / sizeof(size_t)));
+	EXPECT_EQ(26 * sizeof(size_t), ptr.bytesRemaining());
+
+	// splice into an empty view
+	VirtualPointer<size_t, CheckedAccess, ChunkTable> empty{};
+	empty.splice(0, other);
+	EXPECT_EQ(22, *empty);
+	EXPECT_EQ(6 * sizeof(size_t), empty.bytesRemaining());
+}
+
+TEST(EditView, splice) {
+	Splice<VectorChunkTable<size_t>>();
+	Splice<RopeChunkTable<size_t>>();
+}
+
+TEST(EditView, exceptions) {
+	size_t arr[16] = {};
+	VirtualPointer<size_t> ptr{};
+	VirtualPointer<size_t> empty{};
+	ptr.addChunk(arr, 8);
+	ptr.addChunk(arr + 8, 8);
+	ptr += 4;
+
+	EXPECT_THROW(ptr.insert(13, arr, 1), std::out_of_range);
+	EXPECT_THROW(ptr.erase(10, 3), std::out_of_range);
+	EXPECT_THROW(ptr.splice(0, empty), std::out_of_range);
+	EXPECT_NO_THROW(ptr.insert(12, arr, 1));
+	EXPECT_NO_THROW(ptr.erase(10, 3));
+	EXPECT_EQ(10 * sizeof(size_t), ptr.bytesRemaining());
+}
+
+/*
+*
+*
+*	Chunk tables: VirtualPointer<T, AccessPolicy, CompactChunkTable<T>>
+*
+*
+*/
+
+TEST(CompactChunkTable, moveAndCopyInDiscontinuousMemory) {
+	constexpr size_t count = 64;
+	uint16_t arr[count];
+	uint16_t out[count] = {};
+	for (size_t i = 0; i < count; ++i) {
+		arr[i] = static_cast<uint16_t>(i);
+	}
+
+	VirtualPointer<uint16_t, CheckedAccess, CompactChunkTable<uint16_t>> ptr{};
+	ptr.addChunk(arr, 8);
+	ptr.addChunk(arr + 16, 16);
+	ptr.addChunk(arr + 40, 24);
+	EXPECT_EQ(48 * sizeof(uint16_t), ptr.bytesRemaining());
+
+	EXPECT_EQ(0, *ptr);
+	EXPECT_EQ(16, ptr[8]);
+	EXPECT_EQ(63, ptr[47]);
+	ptr += 24;
+	EXPECT_EQ(40, *ptr);
+	ptr -= 17;
+	EXPECT_EQ(7, *ptr);
+
+	memcpy(out, ptr, 10);
+	EXPECT_EQ(0, memcmp(out, arr + 7, sizeof(uint16_t)));
+	EXPECT_EQ(0, memcmp(out + 1, arr + 16, 9 * sizeof(uint16_t)));
+
+	ptr.erase(1, 16);
+	EXPECT_EQ(7, *ptr);
+	EXPECT_EQ(40, ptr[1]);
+	ptr.insert(1, arr + 2, 2);
+	EXPECT_EQ(2, ptr[1]);
+	EXPECT_EQ(3, ptr[2]);
+	EXPECT_EQ(40, ptr[3]);
+}
+
+TEST(CompactChunkTable, exceptions) {
+	uint16_t arr[16] = {};
+	VirtualPointer<uint16_t, CheckedAccess, CompactChunkTable<uint16_t>> ptr{};
+	ptr.addChunk(arr + 8, 8);
+
+	// the chunk begins before the base chunk
+	EXPECT_THROW(ptr.addChunk(arr, 8), std::out_of_range);
+	EXPECT_EQ(8 * sizeof(uint16_t), ptr.bytesRemaining());
+	EXPECT_THROW(ptr.insert(0, arr, 8), std::out_of_range);
+	EXPECT_EQ(8 * sizeof(uint16_t), ptr.bytesRemaining());
+	ptr += 8;
+	EXPECT_THROW(ptr.addChunk(arr, 8), std::out_of_range);
+	ptr.addChunk(arr + 8, 4);
+	EXPECT_FALSE(ptr.isOverflow());
+	EXPECT_EQ(4 * sizeof(uint16_t), ptr.bytesRemaining());
+
+	CompactChunkTable<uint16_t> table{};
+	EXPECT_THROW(table.append(arr, static_cast<size_t>(std::numeric_limits<uint32_t>::max()) + 1), std::out_of_range);
+	EXPECT_TRUE(table.empty());
+}
+
+/*
+*
+*
+*	Chunk tables: VirtualPointer<T, AccessPolicy, RopeChunkTable<T>>
+*
+*
+*/
+
+TEST(RopeChunkTable, sameChunksAsVectorTable) {
+	uint8_t arr[1024] = {};
+	VectorChunkTable<uint8_t> vector{};
+	RopeChunkTable<uint8_t> rope{};
+	uint32_t random = 1;
+	const auto next = [&random](size_t bound) {
+		random = random * 1664525 + 1013904223;
+		return static_cast<size_t>(random >> 8) % bound;
+	};
+
+	for (size_t i = 0; i < 2000; ++i) {
+		const size_t length = next(16);
+		uint8_t* chunk = arr + next(1000);
+		switch (next(5)) {
+		case 0:
+			vector.append(chunk, length);
+			rope.append(chunk, length);
+			break;
+		case 1: {
+			const size_t idx = next(vector.size() + 1);
+			vector.insert(idx, chunk, length);
+			rope.insert(idx, chunk, length);
+			break;
+		}
+		case 2: {
+			const size_t first = next(vector.size() + 1);
+			const size_t last = first + next(std::min<size_t>(vector.size() - first, 4) + 1);
+			vector.erase(first, last);
+			rope.erase(first, last);
+			break;
+		}
+		case 3:
+			if (!vector.empty()) {
+				const size_t idx = next(vector.size());
+				vector.setLength(idx, length);
+				rope.setLength(idx, length);
+			}
+			break;
+		default: {
+			// the table inserts a part of its own copy
+			const size_t idx = next(vector.size() + 1);
+			const size_t first = next(vector.size() + 1);
+			const auto vectorCopy = vector;
+			const auto ropeCopy = rope;
+			vector.insert(idx, vectorCopy, first);
+			rope.insert(idx, ropeCopy, first);
+			break;
+		}
+		}
+		if (vector.size() > 200) {
+			vector.erase(0, 100);
+			rope.erase(0, 100);
+		}
+
+		ASSERT_EQ(vector.size(), rope.size());
+		ASSERT_EQ(vector.offset(vector.size()), rope.offset(rope.size()));
+		const size_t idx = next(vector.size() + 1);
+		ASSERT_EQ(vector.offset(idx), rope.offset(idx));
+		size_t vectorOffset = next(vector.offset(vector.size()) + 4);
+		size_t ropeOffset = vectorOffset;
+		ASSERT_EQ(vector.find(vectorOffset), rope.find(ropeOffset));
+		ASSERT_EQ(vectorOffset, ropeOffset);
+	}
+	for (size_t i = 0; i < vector.size(); ++i) {
+		EXPECT_EQ(vector.pointer(i), rope.pointer(i));
+		EXPECT_EQ(vector.length(i), rope.length(i));
+	}
+}
+
+TEST(RopeChunkTable, editsKeepLogarithmicHeight) {
+	constexpr size_t chunksCount = 100000;
+	std::vector<uint8_t> arr(2 * chunksCount);
+	RopeChunkTable<uint8_t> table{};
+	for (size_t i = 0; i < chunksCount; ++i) {
+		table.append(arr.data() + 2 * i, 2);
+	}
+	RopeChunkTable<uint8_t> other{};
+	for (size_t i = 0; i < 100; ++i) {
+		other.append(arr.data() + i, 1);
+	}
+	// an edit takes O(height) nodes, the height of an AVL tree of n nodes is less than 1.44 * log2(n + 2)
+	const auto maxHeight = [&table]() {
+		return static_cast<size_t>(1.44 * std::log2(static_cast<double>(table.size() + 2)));
+	};
+	EXPECT_GE(maxHeight(), table.height());
+	for (size_t i = 0; i < 10000; ++i) {
+		const size_t idx = (i * 7919) % table.size();
+		switch (i % 4) {
+		case 0:
+			table.insert(idx, arr.data(), 1);
+			break;
+		case 1:
+			table.erase(idx, std::min(idx + 3, table.size()));
+			break;
+		case 2:
+			table.insert(idx, other, i % 100);
+			break;
+		default:
+			table.setLength(idx, 1);
+			break;
+		}
+	}
+	EXPECT_GE(maxHeight(), table.height());
+	// the edits at one end are the worst case for the balance of the tree built by appends
+	for (size_t i = 0; i < 10000; ++i) {
+		table.insert(0, arr.data(), 1);
+		table.erase(table.size() - 2, table.size());
+	}
+	EXPECT_GE(maxHeight(), table.height());
+}
+
+/*
+*
+*
+*	Forks: VirtualPointer::fork
+*
+*
+*/
+
+template<typename ChunkTable>
+void ForkDoesNotSeeChunksOfOriginal() {
+	constexpr size_t count = 64;
+	uint16_t arr[count];
+	for (size_t i = 0; i < count; ++i) {
+		arr[i] = static_cast<uint16_t>(i);
+	}
+
+	VirtualPointer<uint16_t, CheckedAccess, ChunkTable> ptr{};
+	ptr.addChunk(arr, 8);
+	ptr.addChunk(arr + 16, 8);
+	auto copy = ptr;
+	auto fork = ptr.fork();
+	auto secondFork = ptr.fork();
+	EXPECT_EQ(16 * sizeof(uint16_t), fork.bytesRemaining());
+
+	// the first append is done in place of the shared chunks
+	fork.addChunk(arr + 32, 8);
+	ptr.addChunk(arr + 48, 8);
+	secondFork.addChunk(arr + 40, 4);
+
+	EXPECT_EQ(24 * sizeof(uint16_t), fork.bytesRemaining());
+	EXPECT_EQ(32, fork[16]);
+	EXPECT_EQ(24 * sizeof(uint16_t), ptr.bytesRemaining());
+	EXPECT_EQ(48, ptr[16]);
+	EXPECT_EQ(24 * sizeof(uint16_t), copy.bytesRemaining());
+	EXPECT_EQ(48, copy[16]);
+	EXPECT_EQ(20 * sizeof(uint16_t), secondFork.bytesRemaining());
+	EXPECT_EQ(40, secondFork[16]);
+	EXPECT_EQ(43, secondFork[19]);
+
+	// the position is forked too
+	ptr += 10;
+	auto thirdFork = ptr.fork();
+	EXPECT_EQ(18, *thirdFork);
+	thirdFork.erase(0, 6);
+	EXPECT_EQ(48, *thirdFork);
+	EXPECT_EQ(18, *ptr);
+	EXPECT_EQ(14 * sizeof(uint16_t), ptr.bytesRemaining());
+	fork += 16;
+	EXPECT_EQ(32, *fork);
+}
+
+TEST(Fork, ForkDoesNotSeeChunksOfOriginal) {
+	ForkDoesNotSeeChunksOfOriginal<VectorChunkTable<uint16_t>>();
+	ForkDoesNotSeeChunksOfOriginal<CompactChunkTable<uint16_t>>();
+	ForkDoesNotSeeChunksOfOriginal<RopeChunkTable<uint16_t>>();
+}
+
+TEST(ContiguousData, spanOfCurrentChunk) {
+	size_t arr[16] = {};
+	VirtualPointer<size_t> ptr{};
+	size_t count = 1;
+	EXPECT_EQ(nullptr, ptr.contiguousData(count));
+	EXPECT_EQ(0, count);
+
+	ptr.addChunk(arr, 4);
+	ptr.addChunk(arr + 8, 8);
+	EXPECT_EQ(arr, ptr.contiguousData(count));
+	EXPECT_EQ(4, count);
+	ptr += 3;
+	EXPECT_EQ(arr + 3, ptr.contiguousData(count));
+	EXPECT_EQ(1, count);
+	ptr += 3;
+	EXPECT_EQ(arr + 10, ptr.contiguousData(count));
+	EXPECT_EQ(6, count);
+
+	// the position at the end of the chunk of a copy is moved to the chunk added after
+	VirtualPointer<size_t> copy = ptr;
+	copy += 6;
+	EXPECT_EQ(nullptr, copy.contiguousData(count));
+	EXPECT_EQ(0, count);
+	ptr.addChunk(arr + 4, 2);
+	EXPECT_EQ(arr + 4, copy.contiguousData(count));
+	EXPECT_EQ(2, count);
+}
+
+TEST(Position, setPositionRestoresPosition) {
+	uint16_t arr[16];
+	for (uint16_t i = 0; i < 16; ++i)
+	{
+		arr[i] = i;
+	}
+	VirtualPointer<uint16_t> ptr{};
+	ptr.addChunk(arr, 3);
+	ptr.addChunk(arr + 3, 5);
+	ptr.addChunk(arr + 8, 8);
+	ptr += 2;
+	const auto position = ptr.getPosition();
+	ptr += 9;
+	EXPECT_EQ(11, *ptr);
+	ptr.setPosition(position);
+	EXPECT_EQ(2, *ptr);
+	EXPECT_EQ(14 * sizeof(uint16_t), ptr.bytesRemaining());
+	ptr += 13;
+	EXPECT_EQ(15, *ptr);
+
+	// the chunks added after the position was taken are counted
+	const auto end = ptr.getPosition();
+	uint16_t tail[2] = { 16, 17 };
+	ptr.addChunk(tail, 2);
+	ptr.setPosition(end);
+	EXPECT_EQ(3 * sizeof(uint16_t), ptr.bytesRemaining());
+	ptr += 2;
+	EXPECT_EQ(17, *ptr);
+}